@@ -40,29 +40,72 @@
 #include "G4UImanager.hh"
 #include "G4String.hh"
 
-#include "FTFP_BERT.hh"
-#include "G4OpticalPhysics.hh"
-#include "G4EmStandardPhysics_option4.hh"
-
 #include "DetectorConstruction.hh"
+#include "PhysicsList.hh"
+#include "ParameterSweep.hh"
+#include "ProcessInfo.hh"
 
 #include "ActionInitialization.hh"
 
 #include "G4VisExecutive.hh"
 #include "G4UIExecutive.hh"
 
+#include <cstdlib>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+namespace {
+  void PrintUsage()
+  {
+    G4cerr << " Usage: OpNovice2 [macro] [-m macro] [-p physics] [-c dir]"
+           << " [-t threads]\n"
+           << "   physics: optical, em or full (default full, or the\n"
+           << "            value of the OPNOVICE2_PHYSICS variable)\n"
+           << "   dir:     physics table cache (or OPNOVICE2_TABLE_CACHE)\n"
+           << "   threads: worker threads (default: cores, at most 4)"
+           << G4endl;
+  }
+}
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 int main(int argc, char** argv)
 {
+  ProcessInfo::Start();
+
+  //evaluate arguments; a bare argument is the macro, as before
+  G4String macro;
+  G4String physicsMode = "full";
+  G4String tableCache;
+  G4int nThreads = 0;
+  if (const char* env = std::getenv("OPNOVICE2_PHYSICS")) physicsMode = env;
+  if (const char* env = std::getenv("OPNOVICE2_TABLE_CACHE")) tableCache = env;
+  for (G4int i = 1; i < argc; ++i) {
+    G4String arg = argv[i];
+    if      (arg == "-m" && i+1 < argc) macro = argv[++i];
+    else if (arg == "-p" && i+1 < argc) physicsMode = argv[++i];
+    else if (arg == "-c" && i+1 < argc) tableCache = argv[++i];
+    else if (arg == "-t" && i+1 < argc) nThreads = std::atoi(argv[++i]);
+    else if (arg[0] != '-') macro = arg;
+    else {
+      PrintUsage();
+      return 1;
+    }
+  }
+  if (!PhysicsList::IsValidMode(physicsMode)) {
+    PrintUsage();
+    return 1;
+  }
 
-  //detect interactive mode (if no arguments) and define UI session
+  //detect interactive mode (if no macro) and define UI session
   G4UIExecutive* ui = nullptr;
-  if (argc == 1) ui = new G4UIExecutive(argc,argv);
+  if (macro.empty()) ui = new G4UIExecutive(argc,argv);
 
 #ifdef G4MULTITHREADED
   G4MTRunManager * runManager = new G4MTRunManager;
-  G4int nThreads = std::min(G4Threading::G4GetNumberOfCores(), 4);
+  if (nThreads <= 0) {
+    nThreads = std::min(G4Threading::G4GetNumberOfCores(), 4);
+  }
   runManager->SetNumberOfThreads(nThreads);
   G4cout << "===== OpNovice2 is started with "
          <<  runManager->GetNumberOfThreads() << " threads =====" << G4endl;
@@ -73,15 +116,14 @@ int main(int argc, char** argv)
   DetectorConstruction* detector = new DetectorConstruction();
   runManager->SetUserInitialization(detector);
 
-  G4VModularPhysicsList* physicsList = new FTFP_BERT;
-  physicsList->ReplacePhysics(new G4EmStandardPhysics_option4());
-  G4OpticalPhysics* opticalPhysics = new G4OpticalPhysics();
-
-  physicsList->RegisterPhysics(opticalPhysics);
+  PhysicsList* physicsList = new PhysicsList(physicsMode);
+  if (!tableCache.empty()) physicsList->SetTableCache(tableCache);
   runManager->SetUserInitialization(physicsList);
 
   runManager->SetUserInitialization(new ActionInitialization());
 
+  ParameterSweep* sweep = new ParameterSweep();
+
   //initialize visualization
   G4VisManager* visManager = new G4VisExecutive;
   visManager->Initialize();
@@ -98,11 +140,11 @@ int main(int argc, char** argv)
   else  {
     //batch mode  
     G4String command = "/control/execute ";
-    G4String fileName = argv[1];
-    UImanager->ApplyCommand(command+fileName);
+    UImanager->ApplyCommand(command+macro);
   }
 
   // job termination
+  delete sweep;
   delete visManager;
   delete runManager;
   return 0;
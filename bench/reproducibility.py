@@ -0,0 +1,243 @@
+#!/usr/bin/env python3
+"""Checks that OpNovice2 results do not depend on threads or sharding.
+
+The same configuration (bench/reproducibility.mac by default) is run with
+per-event seeding (/opnovice2/run/eventSeed) at every requested thread
+count, and once more split into shards, each a separate job with its own
+/opnovice2/run/eventOffset. The "Counters:" line printed by Run at end of
+run (raw counts, photon energy sums and an order-independent digest of
+the ntuple rows) and the merged histograms written as text are compared
+with the first configuration. Shards are summed before the comparison.
+
+Integer counts, the hit count and the hit digest must be identical; sums
+of floating-point numbers may differ by the rounding of a different
+summation order and are compared with a relative tolerance. With
+--statistical, counts that differ are accepted when they are compatible
+within three standard deviations, for set-ups that cannot be exactly
+reproducible. The script exits with status 1 if a check fails.
+"""
+
+import argparse
+import glob
+import math
+import os
+import re
+import subprocess
+import sys
+
+BENCH_DIR = os.path.dirname(os.path.abspath(__file__))
+OUTPUT_PATTERN = "opnovice2*"
+HISTOGRAM_FILE = "opnovice2.ascii"
+
+# sums of doubles, their last bits depend on the summation order
+FLOAT_COUNTERS = ("cerenkovEnergy", "scintillationEnergy")
+
+
+def parse_counters(output):
+    """Returns the key=value pairs of the last Counters line."""
+    values = None
+    for line in output.splitlines():
+        match = re.match(r"^Counters: (.*)$", line)
+        if match:
+            values = dict(item.split("=", 1) for item in match.group(1).split())
+    if values is None:
+        return None
+    counters = {}
+    for key, value in values.items():
+        if key == "hitDigest":
+            counters[key] = int(value, 16)
+        elif key in FLOAT_COUNTERS:
+            counters[key] = float(value)
+        else:
+            counters[key] = int(value)
+    return counters
+
+
+def parse_histograms(path):
+    """Returns {histogram id: {bin: content}} from the analysis text dump."""
+    histograms = {}
+    if not os.path.exists(path):
+        return histograms
+    current = None
+    with open(path) as f:
+        for line in f:
+            match = re.match(r"^\s*1D histogram (\d+)", line)
+            if match:
+                current = histograms.setdefault(int(match.group(1)), {})
+                continue
+            fields = line.split()
+            if current is None or len(fields) != 3:
+                continue
+            try:
+                current[int(fields[0])] = float(fields[2])
+            except ValueError:
+                pass
+    return histograms
+
+
+def run(exe, workdir, setup, seed, offset, events, threads):
+    for old in glob.glob(os.path.join(workdir, OUTPUT_PATTERN)):
+        os.remove(old)
+    driver = os.path.join(workdir, "reproducibility_driver.mac")
+    with open(driver, "w") as f:
+        f.write("/opnovice2/run/eventSeed %d\n" % seed)
+        f.write("/opnovice2/run/eventOffset %d\n" % offset)
+        f.write("/control/execute %s\n" % setup)
+        f.write("/run/beamOn %d\n" % events)
+
+    command = [exe, "-t", str(threads), "-m", driver]
+    proc = subprocess.run(command, cwd=workdir, stdout=subprocess.PIPE,
+                          stderr=subprocess.STDOUT, universal_newlines=True)
+    os.remove(driver)
+    if proc.returncode != 0:
+        sys.stderr.write(proc.stdout[-4000:])
+        raise RuntimeError("%s failed with status %d"
+                           % (" ".join(command), proc.returncode))
+    counters = parse_counters(proc.stdout)
+    if counters is None:
+        raise RuntimeError("no Counters line in the output of %s"
+                           % " ".join(command))
+    histograms = parse_histograms(os.path.join(workdir, HISTOGRAM_FILE))
+    return counters, histograms
+
+
+def add(total, part):
+    """Adds the counters and histograms of one shard to the total."""
+    counters, histograms = part
+    if total is None:
+        return dict(counters), {h: dict(b) for h, b in histograms.items()}
+    for key, value in counters.items():
+        if key == "hitDigest":
+            total[0][key] = (total[0].get(key, 0) + value) % (1 << 64)
+        else:
+            total[0][key] = total[0].get(key, 0) + value
+    for h, bins in histograms.items():
+        target = total[1].setdefault(h, {})
+        for b, content in bins.items():
+            target[b] = target.get(b, 0.) + content
+    return total
+
+
+def compatible(a, b):
+    """True if two counts agree within three standard deviations."""
+    return abs(a - b) <= 3. * math.sqrt(max(a + b, 1.))
+
+
+def compare(name, reference, result, args):
+    problems = []
+    ref_counters, ref_histograms = reference
+    counters, histograms = result
+
+    for key in sorted(set(ref_counters) | set(counters)):
+        old, new = ref_counters.get(key, 0), counters.get(key, 0)
+        if old == new:
+            continue
+        if key in FLOAT_COUNTERS:
+            if abs(new - old) <= args.tolerance * max(abs(old), abs(new)):
+                continue
+        elif key == "hitDigest":
+            if args.statistical:
+                continue
+            problems.append("%s: hit lists differ (digest %016x, was %016x)"
+                            % (name, new, old))
+            continue
+        if args.statistical and compatible(old, new):
+            continue
+        problems.append("%s: %s = %s, reference %s" % (name, key, new, old))
+
+    for h in sorted(set(ref_histograms) | set(histograms)):
+        old_bins, new_bins = ref_histograms.get(h, {}), histograms.get(h, {})
+        for b in sorted(set(old_bins) | set(new_bins)):
+            old, new = old_bins.get(b, 0.), new_bins.get(b, 0.)
+            if abs(new - old) <= args.histogram_tolerance * \
+                    max(abs(old), abs(new)):
+                continue
+            if args.statistical and compatible(old, new):
+                continue
+            problems.append("%s: histogram %d bin %d = %g, reference %g"
+                            % (name, h, b, new, old))
+    return problems
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--exe", default="./OpNovice2",
+                        help="OpNovice2 executable")
+    parser.add_argument("--workdir", default=None,
+                        help="directory to run in "
+                             "(default: the directory of the executable)")
+    parser.add_argument("--setup",
+                        default=os.path.join(BENCH_DIR, "reproducibility.mac"),
+                        help="macro with the configuration, without beamOn")
+    parser.add_argument("--events", type=int, default=200,
+                        help="events per configuration")
+    parser.add_argument("--threads", default="1,2,4,N",
+                        help="comma separated thread counts, N for all cores")
+    parser.add_argument("--shards", type=int, default=3,
+                        help="number of shards of the sharded run, 0 for none")
+    parser.add_argument("--shard-threads", type=int, default=2,
+                        help="threads of each shard")
+    parser.add_argument("--seed", type=int, default=4242,
+                        help="value of /opnovice2/run/eventSeed")
+    parser.add_argument("--tolerance", type=float, default=1e-9,
+                        help="relative tolerance on floating-point sums")
+    parser.add_argument("--histogram-tolerance", type=float, default=1e-5,
+                        help="relative tolerance on histogram bins, which "
+                             "are written with limited precision")
+    parser.add_argument("--statistical", action="store_true",
+                        help="accept counts compatible within 3 sigma")
+    args = parser.parse_args()
+
+    exe = os.path.abspath(args.exe)
+    workdir = os.path.abspath(args.workdir or os.path.dirname(exe))
+    setup = os.path.abspath(args.setup)
+
+    threads = []
+    for t in args.threads.split(","):
+        if t.strip().upper() == "N":
+            n = os.cpu_count() or 1
+        else:
+            n = int(t)
+        if n not in threads:
+            threads.append(n)
+
+    results = []
+    for n in threads:
+        print("running %d events with %d thread(s)" % (args.events, n))
+        results.append(("%d thread(s)" % n,
+                        run(exe, workdir, setup, args.seed, 0,
+                            args.events, n)))
+
+    if args.shards > 0:
+        total = None
+        first = 0
+        for k in range(args.shards):
+            last = (k + 1) * args.events // args.shards
+            print("running shard %d: events %d to %d with %d thread(s)"
+                  % (k, first, last - 1, args.shard_threads))
+            total = add(total, run(exe, workdir, setup, args.seed, first,
+                                   last - first, args.shard_threads))
+            first = last
+        results.append(("%d shards" % args.shards, total))
+
+    name, reference = results[0]
+    print("reference: %s, %d hits, digest %016x"
+          % (name, reference[0].get("hits", 0),
+             reference[0].get("hitDigest", 0)))
+    if not reference[1]:
+        print("no %s, histograms not compared" % HISTOGRAM_FILE)
+
+    problems = []
+    for name, result in results[1:]:
+        found = compare(name, reference, result, args)
+        print("%-14s %s" % (name, "consistent" if not found else
+                            "%d difference(s)" % len(found)))
+        problems.extend(found)
+
+    for problem in problems:
+        print("MISMATCH " + problem)
+    return 1 if problems else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
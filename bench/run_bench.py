@@ -0,0 +1,208 @@
+#!/usr/bin/env python3
+"""Runs the OpNovice2 benchmark workloads and writes a JSON report.
+
+Each workload in this directory (photon, scintillation, cerenkov) is run
+with fixed seeds at every requested thread count. The "Benchmark:" line
+printed by RunAction at the end of the run provides the event, step and
+photon counts; the report adds the rates, the peak RSS, the start-up time
+and the size of the analysis output per event.
+
+With --baseline the results are compared to an earlier report: rates
+lower, or memory, start-up time and output size higher than the baseline
+by more than the tolerance are listed as regressions, and the script
+exits with status 1. --save-baseline stores the new report as baseline.
+No baseline is kept in the repository, the numbers depend on the machine;
+record one on the machine that runs the comparisons.
+"""
+
+import argparse
+import json
+import os
+import platform
+import re
+import subprocess
+import sys
+import time
+
+BENCH_DIR = os.path.dirname(os.path.abspath(__file__))
+WORKLOADS = ["photon", "scintillation", "cerenkov"]
+# the analysis output: opnovice2.root, or one opnovice2_t<N>.root per
+# worker; the summaries, digests and spectra written next to it are not
+# counted
+OUTPUT_RE = re.compile(r"^opnovice2(_t\d+)?\.root$")
+
+# metric -> True if higher is better
+METRICS = {
+    "events_per_s": True,
+    "steps_per_s": True,
+    "tracked_photons_per_s": True,
+    "peak_rss_mb": False,
+    "startup_s": False,
+    "output_bytes_per_event": False,
+}
+
+# hardware counters, reported when /opnovice2/run/perfCounters is on and
+# perf is available; not compared, they vary between machines
+COUNTERS = {
+    "ipc": "ipc",
+    "cacheMissesPerStep": "cache_misses_per_step",
+    "branchMissesPerStep": "branch_misses_per_step",
+}
+
+
+def parse_benchmark_line(output):
+    """Returns the key=value pairs of the last master Benchmark line."""
+    values = None
+    for line in output.splitlines():
+        match = re.match(r"^Benchmark: (.*)$", line)
+        if match:
+            values = dict(item.split("=", 1) for item in match.group(1).split())
+    if values is None:
+        return None
+    return {key: float(value) for key, value in values.items()}
+
+
+def analysis_outputs(workdir):
+    """Returns the paths of the analysis output files in workdir."""
+    return [os.path.join(workdir, name) for name in os.listdir(workdir)
+            if OUTPUT_RE.match(name)]
+
+
+def run_workload(exe, workdir, workload, threads):
+    for old in analysis_outputs(workdir):
+        os.remove(old)
+
+    macro = os.path.join(BENCH_DIR, workload + ".mac")
+    command = [exe, "-t", str(threads), "-m", macro]
+    start = time.time()
+    proc = subprocess.run(command, cwd=workdir, stdout=subprocess.PIPE,
+                          stderr=subprocess.STDOUT, universal_newlines=True)
+    wall = time.time() - start
+    if proc.returncode != 0:
+        sys.stderr.write(proc.stdout[-4000:])
+        raise RuntimeError("%s failed with status %d"
+                           % (" ".join(command), proc.returncode))
+
+    bench = parse_benchmark_line(proc.stdout)
+    if bench is None:
+        raise RuntimeError("no Benchmark line in the output of %s"
+                           % " ".join(command))
+
+    output_bytes = sum(os.path.getsize(f) for f in analysis_outputs(workdir))
+    events = max(bench["events"], 1.)
+    seconds = max(bench["seconds"], 1e-9)
+    result = {
+        "workload": workload,
+        "threads": threads,
+        "events": int(bench["events"]),
+        "run_s": bench["seconds"],
+        "wall_s": round(wall, 3),
+        "events_per_s": bench["events"] / seconds,
+        "steps_per_s": bench["steps"] / seconds,
+        "tracked_photons_per_s": bench["trackedPhotons"] / seconds,
+        "peak_rss_mb": bench["peakRSS"],
+        "startup_s": bench["startup"],
+        "output_bytes_per_event": output_bytes / events,
+    }
+    for key, name in COUNTERS.items():
+        if key in bench:
+            result[name] = bench[key]
+    return result
+
+
+def compare(results, baseline, tolerance):
+    reference = {(r["workload"], r["threads"]): r
+                 for r in baseline.get("results", [])}
+    regressions = []
+    for result in results:
+        base = reference.get((result["workload"], result["threads"]))
+        if base is None:
+            continue
+        for metric, higher_is_better in METRICS.items():
+            old, new = base.get(metric), result.get(metric)
+            if not old or new is None:
+                continue
+            change = (new - old) / old
+            if (higher_is_better and change < -tolerance) or \
+               (not higher_is_better and change > tolerance):
+                regressions.append({
+                    "workload": result["workload"],
+                    "threads": result["threads"],
+                    "metric": metric,
+                    "baseline": old,
+                    "value": new,
+                    "change": round(change, 4),
+                })
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--exe", default="./OpNovice2",
+                        help="OpNovice2 executable")
+    parser.add_argument("--workdir", default=None,
+                        help="directory holding the example macros "
+                             "(default: the directory of the executable)")
+    parser.add_argument("--threads", default="1,2,4",
+                        help="comma separated thread counts")
+    parser.add_argument("--workloads", default=",".join(WORKLOADS),
+                        help="comma separated workloads")
+    parser.add_argument("--output", default="bench.json",
+                        help="JSON report to write")
+    parser.add_argument("--baseline", default=None,
+                        help="earlier report to compare with")
+    parser.add_argument("--tolerance", type=float, default=0.10,
+                        help="relative change flagged as regression")
+    parser.add_argument("--save-baseline", action="store_true",
+                        help="write the report to the baseline file too")
+    args = parser.parse_args()
+
+    exe = os.path.abspath(args.exe)
+    workdir = os.path.abspath(args.workdir or os.path.dirname(exe))
+
+    results = []
+    for workload in args.workloads.split(","):
+        for threads in [int(t) for t in args.threads.split(",")]:
+            print("running %s with %d thread(s)" % (workload, threads))
+            result = run_workload(exe, workdir, workload, threads)
+            print("  %.1f events/s, %.3g steps/s, %.3g photons/s, "
+                  "peak RSS %.0f MB" % (result["events_per_s"],
+                  result["steps_per_s"], result["tracked_photons_per_s"],
+                  result["peak_rss_mb"]))
+            results.append(result)
+
+    report = {
+        "version": 1,
+        "date": time.strftime("%Y-%m-%dT%H:%M:%S"),
+        "host": platform.node(),
+        "machine": platform.machine(),
+        "results": results,
+    }
+
+    status = 0
+    if args.baseline and not args.save_baseline:
+        if os.path.exists(args.baseline):
+            with open(args.baseline) as f:
+                baseline = json.load(f)
+            report["baseline"] = os.path.abspath(args.baseline)
+            report["tolerance"] = args.tolerance
+            report["regressions"] = compare(results, baseline, args.tolerance)
+            for r in report["regressions"]:
+                print("REGRESSION %s/%d %s: %.4g -> %.4g (%+.1f%%)"
+                      % (r["workload"], r["threads"], r["metric"],
+                         r["baseline"], r["value"], 100. * r["change"]))
+            status = 1 if report["regressions"] else 0
+        else:
+            print("no baseline %s, nothing to compare" % args.baseline)
+
+    with open(args.output, "w") as f:
+        json.dump(report, f, indent=2)
+    if args.save_baseline and args.baseline:
+        with open(args.baseline, "w") as f:
+            json.dump(report, f, indent=2)
+    print("report written to %s" % args.output)
+    return status
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,90 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/include/CerenkovSource.hh
+/// \brief Definition of the CerenkovSource class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef CerenkovSource_h
+#define CerenkovSource_h 1
+
+#include "G4MaterialPropertyVector.hh"
+#include "G4ThreeVector.hh"
+#include "globals.hh"
+
+#include <vector>
+
+class G4Event;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+// Optical photons with the Cerenkov spectrum and angle of a unit-charge
+// particle of speed beta crossing a segment of the radiator, without
+// tracking the particle. BuildTables() turns the RINDEX vector into an
+// alias table over energy bins once per run, so that every photon costs
+// a constant number of operations: bin from the alias table, energy
+// uniform within the bin, n(E) interpolated between the bin edges.
+
+class CerenkovSource
+{
+  public:
+    CerenkovSource();
+   ~CerenkovSource();
+
+    void SetBeta(G4double b)          {fBeta = b;}
+    void SetSegmentLength(G4double l) {fSegment = l;}
+    // fixed number of photons; 0 draws it from the Frank-Tamm mean
+    void SetNumberOfPhotons(G4int n)  {fNPhotons = n;}
+
+    G4double GetBeta() const {return fBeta;}
+
+    void BuildTables(const G4MaterialPropertyVector* rindex);
+    // mean number of photons on the segment
+    G4double GetMeanNumberOfPhotons() const {return fMeanPerLength*fSegment;}
+
+    // the particle starts at origin along axis at time t0
+    void Generate(G4Event*, const G4ThreeVector& origin,
+                  const G4ThreeVector& axis, G4double t0);
+
+  private:
+    G4double fBeta;
+    G4double fSegment;
+    G4int    fNPhotons;
+
+    G4double fEmin;
+    G4double fBinWidth;
+    G4double fMeanPerLength;
+    std::vector<G4double> fRindex;    // at the bin edges
+    std::vector<G4double> fProb;      // alias acceptance per bin
+    std::vector<G4int>    fAlias;
+
+    std::vector<G4double> fRandom;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif /*CerenkovSource_h*/
@@ -7,8 +7,14 @@
 #include "G4VUserDetectorConstruction.hh"
 #include "G4RunManager.hh"
 
+#include <unordered_map>
+#include <vector>
+
 
 class DetectorMessenger;
+class G4VTouchable;
+class G4Region;
+class G4UserLimits;
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
@@ -21,23 +27,35 @@ public:
   G4VPhysicalVolume* GetTank() {return fTank;}
   G4double GetTankXSize() {return fTank_x;}
 
+  // Named optical surfaces. The /opnovice2/surface* setters below act on
+  // the selected surface; "Surface" exists and is selected by default.
   G4OpticalSurface* GetSurface(void) {return fSurface;}
-
+  G4OpticalSurface* CreateSurface(const G4String& name);
+  G4bool            SelectSurface(const G4String& name);
+  G4OpticalSurface* FindSurface(const G4String& name) const;
+  void              ListSurfaces() const;
+
+  // attach a registered surface between two physical volumes (border)
+  // or around a logical volume (skin); applied when the geometry is
+  // built, or at once if it already exists
+  void AddBorderSurface(const G4String& surface,
+                        const G4String& pv1, const G4String& pv2);
+  void AddSkinSurface(const G4String& surface, const G4String& lv);
+
+  // The surface is looked up by G4OpBoundaryProcess at every boundary
+  // step, so changing it does not require re-closing the geometry.
   void SetSurfaceFinish(const G4OpticalSurfaceFinish finish) {
     fSurface->SetFinish(finish);
-    G4RunManager::GetRunManager()->GeometryHasBeenModified();
   }
   G4OpticalSurfaceFinish GetSurfaceFinish(void) 
   {return fSurface->GetFinish();}
 
   void SetSurfaceType(const G4SurfaceType type) {
     fSurface->SetType(type);
-    G4RunManager::GetRunManager()->GeometryHasBeenModified();
   }
     
   void SetSurfaceModel(const G4OpticalSurfaceModel model) {
     fSurface->SetModel(model);
-    G4RunManager::GetRunManager()->GeometryHasBeenModified();
   }
   G4OpticalSurfaceModel GetSurfaceModel(void) 
   {return fSurface->GetModel();}
@@ -55,17 +73,73 @@ public:
   {return fWorldMPT;}
 
   void AddSurfaceMPV(const char* c, G4MaterialPropertyVector* mpv);
+  void AddSurfaceMPCV(const char* c, G4double v);
   G4MaterialPropertiesTable* GetSurfaceMaterialPropertiesTable() 
   {return fSurfaceMPT;}
 
+  // read property tables and constants for box, world and surface
+  void LoadProperties(const G4String& fileName);
+  // print the MPT of "box", "world", "surface" or "all"
+  void DumpProperties(const G4String& target);
+
   void        SetWorldMaterial(const G4String&);
   G4Material* GetWorldMaterial() const {return fWorldMaterial;}
   void        SetTankMaterial(const G4String&);
   G4Material* GetTankMaterial() const {return fTankMaterial;}
 
+  // N x M array of bars, replicated along x and z
+  void  SetBarArray(G4int nx, G4int nz);
+  G4int GetNumberOfBars() const {return fNBarsX*fNBarsZ;}
+  void  SetBarGap(G4double gap) {fBarGap = gap;}
+
+  // readout plane ID of a touchable in a plane: plane + 10*bar,
+  // where plane is 1 (top) or 2 (bottom) and bar = ix*nz + iz
+  G4int GetDetectorID(const G4VTouchable*) const;
+  // true for the logical volumes of the readout planes
+  G4bool IsReadoutVolume(const G4LogicalVolume*) const;
+  G4bool IsTankVolume(const G4LogicalVolume* lv) const
+    {return lv == fTank_LV;}
+
+  // read the geometry from a GDML file instead of building the bars;
+  // see ConstructFromGDML for the auxiliary tags that are understood
+  void SetGDMLFile(const G4String& fileName) {fGDMLFile = fileName;}
+  const G4String& GetGDMLFile() const {return fGDMLFile;}
+  void WriteGDML(const G4String& fileName);
+
+  // Regions "Tank", "Detector" and "World" (the default region of the
+  // world volume), each with its own production cuts and user limits.
+  // The limits are enforced by G4UserSpecialCuts.
+  void SetRegionCut(const G4String& region, G4double cut);
+  void SetRegionMaxTrackLength(const G4String& region, G4double length);
+  void SetRegionMaxTime(const G4String& region, G4double time);
+  void SetRegionMinEkin(const G4String& region, G4double ekin);
+  void PrintRegions() const;
+
   virtual G4VPhysicalVolume* Construct();
 
 private:
+  // volume2 is empty for a skin surface
+  struct SurfaceBinding {
+    G4String surface;
+    G4String volume1;
+    G4String volume2;
+  };
+
+  // limits of one region, kept next to the G4UserLimits for printing
+  struct RegionLimits {
+    G4String      name;
+    G4double      maxTrackLength;
+    G4double      maxTime;
+    G4double      minEkin;
+    G4UserLimits* limits;
+  };
+  enum {kTankRegion = 0, kDetectorRegion, kWorldRegion, kNRegions};
+
+  G4VPhysicalVolume* ConstructFromGDML();
+  void ApplySurfaceBinding(const SurfaceBinding&);
+  void SetupRegions();
+  RegionLimits* FindRegionLimits(const G4String& region);
+
   G4double fExpHall_x;
   G4double fExpHall_y;
   G4double fExpHall_z;
@@ -76,6 +150,11 @@ private:
   G4double fTank_y;
   G4double fTank_z;
 
+  G4int    fNBarsX;
+  G4int    fNBarsZ;
+  G4double fBarGap;
+
+  G4VPhysicalVolume* fWorld_PV;
   G4LogicalVolume* fWorld_LV;
   G4LogicalVolume* fTank_LV;
 
@@ -85,17 +164,26 @@ private:
   G4VPhysicalVolume* fdet2;
   G4LogicalVolume* fdet2_LV;
 
+  std::vector<G4LogicalVolume*> fReadoutLVs;
+
+  G4Region*    fTankRegion;
+  G4Region*    fDetectorRegion;
+  RegionLimits fRegionLimits[kNRegions];
+  G4String fGDMLFile;
+
   G4Material* fWorldMaterial;
   G4Material* fTankMaterial;
   G4Material* fDetMaterial;
 
   G4OpticalSurface* fSurface;
+  std::unordered_map<std::string, G4OpticalSurface*> fSurfaces;
+  std::vector<SurfaceBinding> fSurfaceBindings;
 
   DetectorMessenger* fDetectorMessenger;
 
   G4MaterialPropertiesTable* fTankMPT;
   G4MaterialPropertiesTable* fWorldMPT;
-  G4MaterialPropertiesTable* fSurfaceMPT;
+  G4MaterialPropertiesTable* fSurfaceMPT;  // of the selected surface
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
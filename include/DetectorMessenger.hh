@@ -57,6 +57,11 @@ class DetectorMessenger: public G4UImessenger
     virtual void SetNewValue(G4UIcommand*, G4String);
 
   private:
+
+    // "<region> <value> <unit>" command for the /opnovice2/region/ limits
+    G4UIcommand* NewRegionCommand(const char* path, const char* guidance,
+                                  const char* unitCategory,
+                                  const char* defaultUnit);
   
     DetectorConstruction*      fDetector;
       
@@ -69,6 +74,14 @@ class DetectorMessenger: public G4UImessenger
     G4UIcmdWithADouble*        fSurfaceSigmaAlphaCmd;
     G4UIcmdWithAString*        fSurfaceMatPropVectorCmd;
 
+    // the surface registry
+    G4UIdirectory*             fSurfaceDir;
+    G4UIcmdWithAString*        fSurfaceCreateCmd;
+    G4UIcmdWithAString*        fSurfaceSelectCmd;
+    G4UIcommand*               fSurfaceBorderCmd;
+    G4UIcommand*               fSurfaceSkinCmd;
+    G4UIcmdWithoutParameter*   fSurfaceListCmd;
+
     // the box 
     G4UIcmdWithAString*        fTankMatPropVectorCmd;
     G4UIcmdWithAString*        fTankMatConstPropVectorCmd;
@@ -79,6 +92,27 @@ class DetectorMessenger: public G4UImessenger
     G4UIcmdWithAString*        fWorldMatConstPropVectorCmd;
     G4UIcmdWithAString*        fWorldMaterialCmd;
 
+    // bar array
+    G4UIcommand*               fBarArrayCmd;
+    G4UIcmdWithADoubleAndUnit* fBarGapCmd;
+
+    // bulk property files
+    G4UIcmdWithAString*        fLoadPropertiesCmd;
+    G4UIcmdWithAString*        fDumpPropertiesCmd;
+
+    // regions
+    G4UIdirectory*             fRegionDir;
+    G4UIcommand*               fRegionCutCmd;
+    G4UIcommand*               fRegionMaxTrackLengthCmd;
+    G4UIcommand*               fRegionMaxTimeCmd;
+    G4UIcommand*               fRegionMinEkinCmd;
+    G4UIcmdWithoutParameter*   fRegionPrintCmd;
+
+    // GDML geometry
+    G4UIdirectory*             fGdmlDir;
+    G4UIcmdWithAString*        fGdmlReadCmd;
+    G4UIcmdWithAString*        fGdmlWriteCmd;
+
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,110 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/include/DetectorTally.hh
+/// \brief Definition of the DetectorTally class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef DetectorTally_h
+#define DetectorTally_h 1
+
+#include "globals.hh"
+
+#include <vector>
+
+class RunSummary;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+// Optical photons reaching the readout planes, each counted once at its
+// first arrival, per detector ID (see DetectorConstruction::GetDetectorID)
+// and as fine-binned spectra of arrival time and wavelength over all
+// detectors. Each Run holds one tally, filled by the stepping action of
+// its thread into plain arrays and merged with the run, so detection
+// efficiencies and timing are known at end of run without writing
+// per-photon ntuple rows. The binning is set between runs;
+// /opnovice2/run/spectraFile also writes the spectra as CSV.
+
+class DetectorTally
+{
+  public:
+    DetectorTally();
+   ~DetectorTally();
+
+    static void SetTimeBinning(G4int bins, G4double min, G4double max);
+    static void SetWavelengthBinning(G4int bins, G4double min, G4double max);
+    static void SetOutputFile(const G4String&);
+    static const G4String& GetOutputFile();
+
+    // time and energy of the photon at the readout plane
+    void AddHit(G4int detector, G4double time, G4double energy);
+
+    void Merge(const DetectorTally&);
+    void Print(G4int events, G4long trackedPhotons) const;
+    void Write(const G4String& fileName) const;
+    void FillSummary(RunSummary&, G4int events) const;
+
+    G4long GetHits() const;
+
+  private:
+    struct Detector {
+      G4long   hits;
+      G4double sumTime;
+      G4double sumTime2;
+      G4double minTime;
+      G4double sumWavelength;
+    };
+
+    struct Spectrum {
+      G4int    bins;
+      G4double min;
+      G4double max;
+      G4double scale;                 // bins per unit
+      std::vector<G4long> counts;     // with underflow and overflow
+
+      void Set(G4int n, G4double lo, G4double hi);
+      void Fill(G4double x)
+      {
+        G4int i = bins + 1;
+        if (x < min) i = 0;
+        else if (x < max) {
+          i = 1 + static_cast<G4int>((x - min)*scale);
+          if (i > bins) i = bins;
+        }
+        ++counts[i];
+      }
+      G4double Quantile(G4double p) const;
+    };
+
+    std::vector<Detector> fDetectors;   // indexed by detector ID
+    Spectrum fTime;
+    Spectrum fWavelength;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif /*DetectorTally_h*/
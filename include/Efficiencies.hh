@@ -0,0 +1,112 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/include/Efficiencies.hh
+/// \brief Definition of the Efficiencies class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef Efficiencies_h
+#define Efficiencies_h 1
+
+#include "globals.hh"
+
+class RunSummary;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+// The efficiencies of the run summary with their uncertainties: the
+// fraction of tracked photons reaching a readout plane, the Fresnel
+// refraction and reflection fractions of the surface events and the
+// fraction of photons absorbed before reaching the surface. Each gets a
+// Wilson score interval, which assumes independent photons, and a
+// batch-means error over batches of events, which also holds when the
+// photons of an event are correlated (showers). The larger of the two
+// is the error used.
+//
+// With /opnovice2/run/beamUntil, every thread adds its counts to shared
+// atomic tallies at the end of each event and checks the chosen
+// quantities; once all reach the target relative error, with at least
+// ten batches so the batch-means error is known, each thread
+// stops its event loop with a soft abort, so /run/beamOn N becomes an
+// upper limit.
+
+class Efficiencies
+{
+  public:
+    enum Quantity {
+      kDetection,
+      kFresnelRefraction,
+      kFresnelReflection,
+      kAbsorptionPrior,
+      kNQuantities
+    };
+
+    Efficiencies();
+   ~Efficiencies();
+
+    static const char* GetName(Quantity);
+    static G4bool      FindQuantity(const G4String& name, Quantity&);
+
+    static void SetBatchSize(G4int events);
+    // 0 switches the adaptive run length off; mask has bit 1<<Quantity set
+    // for the quantities that must reach the precision
+    static void SetTarget(G4double relativeError, G4int mask);
+    // master, begin of run
+    static void ResetTarget();
+
+    // end of event with the thread's cumulative counts of the run;
+    // returns true when the target precision is reached
+    G4bool EndEvent(const G4long pass[], const G4long total[]);
+
+    void Merge(const Efficiencies&);
+    void Print() const;
+    void FillSummary(RunSummary&) const;
+
+    G4double GetValue(Quantity) const;
+    // standard error: the larger of the Wilson and batch-means estimates
+    G4double GetError(Quantity) const;
+    void     GetWilson(Quantity, G4double z, G4double& low,
+                       G4double& high) const;
+    // batch-means standard error, negative with fewer than 10 batches
+    G4double GetBatchError(Quantity) const;
+
+  private:
+    G4long   fPass[kNQuantities];
+    G4long   fTotal[kNQuantities];
+
+    // completed batches: sum and sum of squares of the batch fractions
+    G4long   fBatches[kNQuantities];
+    G4double fBatchSum[kNQuantities];
+    G4double fBatchSum2[kNQuantities];
+    G4long   fBatchPass[kNQuantities];    // counts at the batch start
+    G4long   fBatchTotal[kNQuantities];
+    G4int    fBatchEvents;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif /*Efficiencies_h*/
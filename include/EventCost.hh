@@ -0,0 +1,103 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/include/EventCost.hh
+/// \brief Definition of the EventCost class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef EventCost_h
+#define EventCost_h 1
+
+#include "globals.hh"
+
+#include <vector>
+
+class G4Event;
+class RunSummary;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+// Wall time, steps and tracked photons of every event. Times go into a
+// logarithmic histogram (10 bins per decade from 100 ns to 1000 s) that
+// is merged with the Run and gives the percentiles of the summary, and
+// the N most expensive events are kept with their counts, their global
+// event number and, with /opnovice2/run/eventSeed, their seeds, which
+// identify the event to replay in any shard. Optionally an
+// event slower than a percentile of the events seen so far by its
+// thread is logged right away, with its seeds from EventSeeder; with
+// /random/setSavingFlag its random engine status is also saved as
+// run<R>evt<E>.rndm for replay.
+
+class EventCost
+{
+  public:
+    EventCost();
+   ~EventCost();
+
+    // 0 (default) switches the logging of slow events off
+    static void SetSlowPercentile(G4double);
+    static void SetNumberOfWorst(G4int);
+
+    void BeginEvent(G4long steps, G4long photons);
+    void EndEvent(const G4Event*, G4long steps, G4long photons);
+
+    void Merge(const EventCost&);
+    void Print() const;
+    // the percentiles and most expensive events of Print, in section
+    // event_time
+    void FillSummary(RunSummary&) const;
+
+    // time below which p percent of the events fall
+    G4double Percentile(G4double p) const;
+
+  private:
+    struct Event {
+      G4long   id;         // global event number
+      long     seeds[2];
+      G4bool   seeded;
+      G4double time;
+      G4long   steps;
+      G4long   photons;
+    };
+
+    void KeepWorst(const Event&);
+
+    std::vector<G4long> fBins;   // with underflow and overflow
+    G4long   fEvents;
+    G4double fSumTime;
+    G4long   fSumSteps;
+    G4long   fSumPhotons;
+    std::vector<Event> fWorst;   // sorted, most expensive first
+
+    G4double fStart;
+    G4long   fStartSteps;
+    G4long   fStartPhotons;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif /*EventCost_h*/
@@ -0,0 +1,66 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/include/EventSeeder.hh
+/// \brief Definition of the EventSeeder class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef EventSeeder_h
+#define EventSeeder_h 1
+
+#include "globals.hh"
+
+class G4Event;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+// Per-event random seeds that depend on the global event number alone,
+// so a run gives the same events whatever the number of threads and
+// however it is split into shards. The global number is the G4Event ID
+// plus the offset of the shard; it is also what the ntuple records and
+// what selects the input event of a primary file. With seed 0 (default)
+// the engines keep the seeds Geant4 hands out.
+
+class EventSeeder
+{
+  public:
+    static void   SetSeed(G4long);
+    static G4long GetSeed();
+    static void   SetOffset(G4long);
+    static G4long GetOffset();
+
+    static G4long GetGlobalEventID(const G4Event*);
+    // the two engine seeds of the event; false with seed 0
+    static G4bool GetEventSeeds(const G4Event*, long seeds[2]);
+
+    // first thing in GeneratePrimaries, before any random number is drawn
+    static void Seed(const G4Event*);
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif /*EventSeeder_h*/
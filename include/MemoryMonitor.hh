@@ -0,0 +1,93 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/include/MemoryMonitor.hh
+/// \brief Definition of the MemoryMonitor class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef MemoryMonitor_h
+#define MemoryMonitor_h 1
+
+#include "globals.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+// Memory use per event: peak depth of the track stack, size of the
+// thread's TrackInformation allocator pool, process RSS at the begin and
+// end of the event and the ntuple rows the event adds to the output
+// buffers. Each Run holds one monitor, filled by the event, tracking and
+// stepping actions of its thread and merged with the run. An event
+// exceeding one of the budgets raises a warning (once per run and
+// quantity), so batch slots can be sized from real numbers. Off unless
+// /opnovice2/run/memory is set; RSS is read from /proc twice per event.
+
+class MemoryMonitor
+{
+  public:
+    MemoryMonitor();
+   ~MemoryMonitor();
+
+    static void   SetEnabled(G4bool);
+    static G4bool IsEnabled();
+
+    // 0 means no limit
+    static void SetStackBudget(G4int tracks);
+    static void SetRSSBudget(G4double MB);
+    static void SetAllocatorBudget(G4double MB);
+    static void SetNtupleRowBudget(G4int rows);
+
+    void BeginEvent();
+    void SampleStack();
+    void AddNtupleRow() {++fEventRows;}
+    void EndEvent(G4int eventID);
+
+    void Merge(const MemoryMonitor&);
+    void Print() const;
+
+  private:
+    void Warn(G4int bit, G4int eventID, const G4String& what);
+
+    // current event
+    G4int    fEventStack;
+    G4int    fEventRows;
+    G4double fEventRSS;
+
+    // run
+    G4int    fEvents;
+    G4int    fMaxStack;
+    G4double fSumStack;
+    G4int    fMaxRows;
+    G4double fSumRows;
+    G4double fMaxAllocator;  // MB
+    G4double fMaxRSS;        // MB
+    G4double fMaxRSSGrowth;  // MB in one event
+    G4int    fWarned;        // bit per quantity
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif /*MemoryMonitor_h*/
@@ -0,0 +1,73 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/include/ParameterSweep.hh
+/// \brief Definition of the ParameterSweep class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef ParameterSweep_h
+#define ParameterSweep_h 1
+
+#include "globals.hh"
+
+#include <vector>
+
+class ParameterSweepMessenger;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+// Runs a list of points within one initialized session. For each point
+// the command template is applied with "{value}" replaced by the point
+// value, a fixed number of events is processed, and one summary row is
+// appended to the output file.
+
+class ParameterSweep
+{
+  public:
+    ParameterSweep();
+   ~ParameterSweep();
+
+    void SetCommand(const G4String& cmd) {fCommand = cmd;}
+    void SetValues(const G4String& list);
+    void SetGrid(G4double vmin, G4double vmax, G4int npoints);
+    void SetEventsPerPoint(G4int n) {fEventsPerPoint = n;}
+    void SetOutputFile(const G4String& name) {fOutputFile = name;}
+
+    void Execute();
+
+  private:
+    G4String              fCommand;
+    std::vector<G4String> fValues;
+    G4int                 fEventsPerPoint;
+    G4String              fOutputFile;
+
+    ParameterSweepMessenger* fMessenger;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif /*ParameterSweep_h*/
@@ -0,0 +1,123 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/include/PerfCounters.hh
+/// \brief Definition of the PerfCounters class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef PerfCounters_h
+#define PerfCounters_h 1
+
+#include "globals.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+// Hardware performance counters (cycles, instructions, cache misses and
+// branch misses, user space only) of the threads that process events,
+// read through perf_event_open on Linux. Each thread opens its counter
+// group at begin of run; the counts of the event loop are accumulated at
+// the end of every event into the PerfCounters of the thread's Run and
+// merged with it. With sections switched on, a Scope additionally
+// charges the counts of our stepping, tracking and event actions to its
+// section; the rest of the run is Geant4 itself (navigation, physics,
+// stacking). Where perf is not available (other systems, containers,
+// perf_event_paranoid > 2) a warning is issued once and the run goes on
+// without counters.
+
+class PerfCounters
+{
+  public:
+    enum Counter {
+      kCycles,
+      kInstructions,
+      kCacheMisses,
+      kBranchMisses,
+      kNCounters
+    };
+
+    enum Section {
+      kStepping,      // SteppingAction
+      kTracking,      // pre- and post-tracking actions
+      kEventActions,  // begin- and end-of-event actions
+      kNSections
+    };
+
+    // inline so that, with counters or sections off, a Scope costs one
+    // thread-local flag test and no call
+    class Scope
+    {
+      public:
+        explicit Scope(Section section)
+          : fSection(section), fActive(fCountSections)
+        { if (fActive) Start(); }
+       ~Scope() { if (fActive) Stop(); }
+      private:
+        void Start();
+        void Stop();
+
+        Section  fSection;
+        G4double fStart[kNCounters];
+        G4bool   fActive;
+    };
+
+    PerfCounters();
+   ~PerfCounters();
+
+    static void   SetEnabled(G4bool);
+    static G4bool IsEnabled();
+    static void   SetSections(G4bool);
+
+    // thread processing the events: open the counters at begin of run,
+    // add the counts of each event, close them at end of run
+    void BeginRun();
+    void EndEvent();
+    static void EndRun();
+
+    void Merge(const PerfCounters&);
+    void Print(G4long steps) const;
+
+    G4bool   IsAvailable(Counter c) const;
+    G4double Get(Counter c) const {return fRun[c];}
+    G4double GetIPC() const;
+
+    static const char* GetCounterName(Counter);
+    static const char* GetSectionName(Section);
+
+  private:
+    // this thread has open counters and sections are on
+    static G4ThreadLocal G4bool fCountSections;
+
+    G4int    fThreads;     // threads that contributed counts
+    G4int    fAvailable;   // bit per counter measured by all of them
+    G4double fRun[kNCounters];
+    G4double fSection[kNSections][kNCounters];
+    G4long   fCalls[kNSections];
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif /*PerfCounters_h*/
@@ -0,0 +1,86 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/include/PhotonSampling.hh
+/// \brief Sampling helpers for optical photon sources
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef PhotonSampling_h
+#define PhotonSampling_h 1
+
+#include "G4ThreeVector.hh"
+#include "G4PhysicalConstants.hh"
+#include "globals.hh"
+
+#include <cmath>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+// Inline helpers shared by the photon sources. All of them take their
+// uniform random numbers as arguments, so a source can draw them for a
+// whole batch at once.
+
+namespace PhotonSampling
+{
+  // Orthonormal basis (b1, b2) transverse to the unit vector n, without
+  // normalisation or branches on the direction (Duff et al., JCGT 2017).
+  inline void TransverseBasis(const G4ThreeVector& n,
+                              G4ThreeVector& b1, G4ThreeVector& b2)
+  {
+    const G4double sign = std::copysign(1., n.z());
+    const G4double a = -1. / (sign + n.z());
+    const G4double b = n.x() * n.y() * a;
+    b1.set(1. + sign * n.x() * n.x() * a, sign * b, -sign * n.x());
+    b2.set(b, sign + n.y() * n.y() * a, -n.y());
+  }
+
+  // direction with cos(theta) uniform in [cosMin, 1] around the axis;
+  // cosMin = -1 gives an isotropic direction
+  inline G4ThreeVector Cone(const G4ThreeVector& axis, G4double cosMin,
+                            G4double u1, G4double u2)
+  {
+    const G4double cosTheta = 1. - u1 * (1. - cosMin);
+    const G4double sinTheta = std::sqrt((1. - cosTheta) * (1. + cosTheta));
+    const G4double phi = twopi * u2;
+    G4ThreeVector b1, b2;
+    TransverseBasis(axis, b1, b2);
+    return cosTheta * axis
+         + sinTheta * (std::cos(phi) * b1 + std::sin(phi) * b2);
+  }
+
+  // linear polarization at angle psi in the plane transverse to k
+  inline G4ThreeVector Polarization(const G4ThreeVector& k, G4double psi)
+  {
+    G4ThreeVector b1, b2;
+    TransverseBasis(k, b1, b2);
+    return std::cos(psi) * b1 + std::sin(psi) * b2;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif /*PhotonSampling_h*/
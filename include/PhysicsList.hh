@@ -0,0 +1,112 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/include/PhysicsList.hh
+/// \brief Definition of the PhysicsList class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef PhysicsList_h
+#define PhysicsList_h 1
+
+#include "G4VModularPhysicsList.hh"
+#include "globals.hh"
+
+class PhysicsTableCache;
+class PhysicsListMessenger;
+class G4OpticalPhysics;
+class G4StepLimiterPhysics;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+// Physics list with three levels of detail:
+//   optical  optical processes only, for optical-photon guns
+//   em       G4EmStandardPhysics_option4 and optical processes
+//   full     FTFP_BERT with G4EmStandardPhysics_option4 and optical
+// All of them include G4StepLimiterPhysics for the region limits, for
+// charged particles unless SetLimitNeutrals is called before
+// initialization.
+
+class PhysicsList : public G4VModularPhysicsList
+{
+  public:
+    PhysicsList(const G4String& mode = "full");
+    virtual ~PhysicsList();
+
+    virtual void ConstructParticle();
+    virtual void SetCuts();
+
+    // keep the physics tables in a cache directory (see PhysicsTableCache)
+    void SetTableCache(const G4String& rootDir);
+    // store the tables once they are built; a no-op on a cache hit
+    void StoreTableCache();
+    // production cuts changed after initialization
+    void CutsChanged();
+
+    const G4String& GetMode() const {return fMode;}
+
+    static G4bool IsValidMode(const G4String&);
+
+    // region limits also for neutrals and optical photons (PreInit)
+    void SetLimitNeutrals(G4bool);
+
+    // Optical process control. Before initialization a process that is
+    // switched off is not constructed at all; afterwards it is
+    // (de)activated. The parameters are applied to the processes of
+    // each thread by ApplyOpticalSettings at the start of every run.
+    G4bool SetOpticalProcessActive(const G4String& process, G4bool active);
+    void   SetCerenkovMaxPhotons(G4int n) {fCerenkovMaxPhotons = n;}
+    void   SetCerenkovMaxBetaChange(G4double v) {fCerenkovMaxBetaChange = v;}
+    void   SetCerenkovTrackSecondariesFirst(G4bool b)
+           {fCerenkovTrackSecondariesFirst = b;}
+    void   SetScintTrackSecondariesFirst(G4bool b)
+           {fScintTrackSecondariesFirst = b;}
+    void   SetScintYieldFactor(G4double v) {fScintYieldFactor = v;}
+
+    void   ApplyOpticalSettings() const;
+    void   PrintOpticalSettings() const;
+
+  private:
+    G4String              fMode;
+    PhysicsTableCache*    fTableCache;
+    G4OpticalPhysics*     fOpticalPhysics;
+    G4StepLimiterPhysics* fStepLimiter;
+    PhysicsListMessenger* fMessenger;
+
+    // negative values mean "Geant4 default"
+    static const G4int kNOpticalProcesses = 7;
+    G4int    fOpticalActive[kNOpticalProcesses];
+    G4int    fCerenkovMaxPhotons;
+    G4double fCerenkovMaxBetaChange;
+    G4int    fCerenkovTrackSecondariesFirst;
+    G4int    fScintTrackSecondariesFirst;
+    G4double fScintYieldFactor;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif /*PhysicsList_h*/
@@ -0,0 +1,78 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/include/PhysicsTableCache.hh
+/// \brief Definition of the PhysicsTableCache class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef PhysicsTableCache_h
+#define PhysicsTableCache_h 1
+
+#include "globals.hh"
+
+class G4VUserPhysicsList;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+// Keeps the physics tables of earlier jobs in <root>/<key>/, where the
+// key is a hash of the Geant4 version, the physics mode, the
+// G4EmParameters settings, the materials with their mean excitation
+// energies and the production cuts of all regions. Prepare() is called from
+// SetCuts(): a complete entry is handed to Geant4's table retrieval,
+// otherwise Store() writes the tables once they are built. Entries are
+// written to a temporary directory and renamed, so concurrent jobs never
+// see a partial entry. Cuts changed after SetCuts() invalidate the entry
+// chosen there, and Store() keys the entry with the cuts current when
+// the tables were built.
+
+class PhysicsTableCache
+{
+  public:
+    PhysicsTableCache(const G4String& rootDir);
+   ~PhysicsTableCache();
+
+    void Prepare(G4VUserPhysicsList*, const G4String& mode);
+    void Store(G4VUserPhysicsList*);
+    // production cuts changed after Prepare: build the tables afresh
+    void Invalidate(G4VUserPhysicsList*);
+
+    G4bool IsRetrieved() const {return fRetrieved;}
+
+  private:
+    G4String BuildKey(const G4String& mode) const;
+
+    G4String fRootDir;
+    G4String fMode;
+    G4String fKey;
+    G4String fEntryDir;
+    G4bool   fRetrieved;
+    G4bool   fStored;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif /*PhysicsTableCache_h*/
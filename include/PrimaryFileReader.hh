@@ -0,0 +1,107 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/include/PrimaryFileReader.hh
+/// \brief Definition of the PrimaryFileReader class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef PrimaryFileReader_h
+#define PrimaryFileReader_h 1
+
+#include "globals.hh"
+
+#include <atomic>
+#include <vector>
+
+class G4Event;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+// Primaries read from a file written by an upstream generator. The file
+// is mapped read-only and indexed once per job; afterwards the reader
+// is immutable, so one instance is shared by all worker threads and each
+// event is decoded straight from the mapping. Event i of the run takes
+// input event first + i, which hands the workers disjoint event ranges
+// independent of the thread count. Input events are never reused: past
+// the end of the file no primaries are made and the run is stopped.
+//
+// Text format (HepEvt-like, '#' starts a comment), per event:
+//
+//   <nParticles>
+//   <pdg> <x> <y> <z> <px> <py> <pz> <t> <polx> <poly> <polz> <weight>
+//   ...
+//
+// in mm, MeV and ns; pdg 0 or -22 is an optical photon. Binary files
+// start with the 8 byte magic "OPN2PRIM", a uint32 version and a uint32
+// record size, followed by 96 byte records
+//
+//   int32 event, int32 pdg, double x, y, z, px, py, pz, t,
+//   polx, poly, polz, weight
+//
+// in the same units, sorted by event.
+
+class PrimaryFileReader
+{
+  public:
+    // shared reader for the file, opened on first use
+    static const PrimaryFileReader* Open(const G4String& fileName);
+
+   ~PrimaryFileReader();
+
+    G4int GetNumberOfEvents() const {return (G4int)fIndex.size() - 1;}
+    const G4String& GetFileName() const {return fFileName;}
+
+    // adds the primaries of input event index to the G4Event; false,
+    // with a warning the first time, when the file has no such event
+    G4bool GenerateEvent(G4Event*, G4int index) const;
+
+  private:
+    PrimaryFileReader(const G4String& fileName);
+
+    struct Particle {
+      G4int    pdg;
+      G4double pos[3], mom[3], time, pol[3], weight;
+    };
+
+    void BuildTextIndex();
+    void BuildBinaryIndex();
+    G4int ReadText(G4int index, std::vector<Particle>&) const;
+    G4int ReadBinary(G4int index, std::vector<Particle>&) const;
+
+    G4String    fFileName;
+    const char* fData;
+    size_t      fSize;
+    G4bool      fBinary;
+    // byte offset of each event (text) or its first record (binary),
+    // with one entry past the last event
+    std::vector<size_t> fIndex;
+    mutable std::atomic<G4bool> fExhausted;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif /*PrimaryFileReader_h*/
@@ -38,8 +38,12 @@
 #include "G4ParticleGun.hh"
 #include "globals.hh"
 
+#include <vector>
+
 class G4Event;
 class PrimaryGeneratorMessenger;
+class PrimaryFileReader;
+class CerenkovSource;
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
@@ -53,12 +57,74 @@ class PrimaryGeneratorAction : public G4VUserPrimaryGeneratorAction
 
     G4ParticleGun* GetParticleGun() {return fParticleGun;};
 
-    void SetOptPhotonPolar();
-    void SetOptPhotonPolar(G4double);
+    // Optical-photon polarization, sampled for every primary: fixed at
+    // an angle w.r.t. the (k, x) plane, uniform random, or partially
+    // linear (fixed with probability "degree", random otherwise). Until
+    // a mode is chosen the gun keeps its own polarization.
+    enum PolarizationMode {kPolarGun, kPolarFixed, kPolarRandom,
+                           kPolarPartial};
+
+    void SetOptPhotonPolar();                 // random
+    void SetOptPhotonPolar(G4double);         // fixed at angle
+    void SetPolarizationMode(PolarizationMode);
+    void SetPolarizationDegree(G4double d) {fPolarDegree = d;}
+
+    // Bulk optical-photon source: K photons per event, all random numbers
+    // of an event drawn in one batch from the thread's engine. The centre
+    // and axis are the /gun/position and /gun/direction; without a
+    // spectrum the photons take the /gun/energy. K = 0 uses the gun.
+    enum PositionMode  {kPoint, kBox, kSurface};
+    enum DirectionMode {kBeam, kIsotropic, kCone};
+
+    void  SetPhotonsPerEvent(G4int);
+    G4int GetPhotonsPerEvent() const {return fPhotonsPerEvent;}
+    void  SetPositionMode(PositionMode m) {fPositionMode = m;}
+    void  SetSourceHalfSize(const G4ThreeVector& v) {fHalfSize = v;}
+    void  SetDirectionMode(DirectionMode m) {fDirectionMode = m;}
+    void  SetConeAngle(G4double a) {fConeAngle = a;}
+    // "unit E1 w1 E2 w2 ...", weights linear in between; empty clears
+    void  SetSpectrum(const G4String&);
+
+    // Primaries streamed from a file (see PrimaryFileReader); event i
+    // of the run takes input event first + i. An empty name returns to
+    // the gun or the photon source.
+    void SetInputFile(const G4String&);
+    void SetInputFirstEvent(G4int n) {fInputFirstEvent = n;}
+
+    // Cerenkov photons of a particle with speed beta starting at the gun
+    // position along the gun direction (see CerenkovSource); the
+    // spectrum follows the RINDEX of the tank material. 0 switches it off.
+    void SetCerenkovBeta(G4double);
+    CerenkovSource* GetCerenkovSource() {return fCerenkov;}
 
   private:
+    void     GeneratePhotons(G4Event*);
+    G4double SampleEnergy(G4double u) const;
+    G4ThreeVector SamplePolarization(const G4ThreeVector& k,
+                                     G4double u1, G4double u2) const;
+
     G4ParticleGun* fParticleGun;
     PrimaryGeneratorMessenger* fGunMessenger;
+
+    G4int         fPhotonsPerEvent;
+    PositionMode  fPositionMode;
+    DirectionMode fDirectionMode;
+    G4ThreeVector fHalfSize;
+    G4double      fConeAngle;
+
+    CerenkovSource*          fCerenkov;
+    G4int                    fCerenkovRunID;
+    const PrimaryFileReader* fInput;
+    G4int                    fInputFirstEvent;
+
+    PolarizationMode fPolarMode;
+    G4double         fPolarAngle;
+    G4double         fPolarDegree;
+
+    std::vector<G4double> fSpectrumEnergy;
+    std::vector<G4double> fSpectrumWeight;
+    std::vector<G4double> fSpectrumCdf;
+    std::vector<G4double> fRandom;
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
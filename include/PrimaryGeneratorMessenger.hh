@@ -41,7 +41,11 @@
 
 class PrimaryGeneratorAction;
 class G4UIdirectory;
+class G4UIcmdWithADouble;
 class G4UIcmdWithADoubleAndUnit;
+class G4UIcmdWithAnInteger;
+class G4UIcmdWithAString;
+class G4UIcmdWith3VectorAndUnit;
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
@@ -57,6 +61,19 @@ class PrimaryGeneratorMessenger: public G4UImessenger
     PrimaryGeneratorAction*         fPrimaryAction;
     G4UIdirectory*                  fGunDir;
     G4UIcmdWithADoubleAndUnit*      fPolarCmd;
+    G4UIcmdWithAString*             fPolarModeCmd;
+    G4UIcmdWithADouble*             fPolarDegreeCmd;
+    G4UIcmdWithAnInteger*           fPhotonsCmd;
+    G4UIcmdWithAString*             fPositionCmd;
+    G4UIcmdWith3VectorAndUnit*      fHalfSizeCmd;
+    G4UIcmdWithAString*             fAngularCmd;
+    G4UIcmdWithADoubleAndUnit*      fConeAngleCmd;
+    G4UIcommand*                    fSpectrumCmd;
+    G4UIcmdWithADouble*             fCerenkovBetaCmd;
+    G4UIcmdWithADoubleAndUnit*      fCerenkovSegmentCmd;
+    G4UIcmdWithAnInteger*           fCerenkovPhotonsCmd;
+    G4UIcommand*                    fInputFileCmd;
+    G4UIcmdWithAnInteger*           fInputFirstCmd;
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
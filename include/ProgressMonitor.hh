@@ -0,0 +1,67 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/include/ProgressMonitor.hh
+/// \brief Definition of the ProgressMonitor class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef ProgressMonitor_h
+#define ProgressMonitor_h 1
+
+#include "globals.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+// Progress of the run as a whole. Every thread publishes its event, step
+// and photon counts at the end of each event into its own cache line,
+// with relaxed atomic stores only, so the event loop never waits on the
+// monitor. A monitor thread started by the master wakes up every
+// interval, sums the slots and prints one line with the rates over the
+// last interval, the output written per second and the ETA; the same
+// numbers can be written to a status file that is replaced atomically
+// (written to <file>.tmp, then renamed) for batch systems to scrape.
+
+class ProgressMonitor
+{
+  public:
+    // 0 switches the monitor off
+    static void SetInterval(G4double seconds);
+    static void SetStatusFile(const G4String&);
+
+    // master, begin and end of run; outputBase is the analysis file
+    // name, its <base>.root and per-worker <base>_t<N>.root count as output
+    static void Start(G4int runID, G4int eventsToProcess,
+                      const G4String& outputBase);
+    static void Stop();
+
+    // any thread, end of event; the counts are totals since begin of run
+    static void Publish(G4long events, G4long steps, G4long photons);
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif /*ProgressMonitor_h*/
@@ -0,0 +1,84 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/include/PropertyLoader.hh
+/// \brief Definition of the PropertyLoader class
+//
+// Reads complete material and surface property sets from a file in a
+// single pass and hands them to the DetectorConstruction.
+//
+// Text format (one directive per line, '#' starts a comment):
+//
+//   table <target> <energyUnit> NAME1[:unit] [NAME2[:unit] ...]
+//   <energy> <value1> [<value2> ...]
+//   ...
+//   end
+//   const <target> NAME[:unit] <value>
+//
+// where <target> is box, world or surface. Binary files start with the
+// 8 byte magic "OPN2PROP" and store the same blocks in internal units.
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef PropertyLoader_h
+#define PropertyLoader_h 1
+
+#include "globals.hh"
+
+#include <vector>
+
+class DetectorConstruction;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+class PropertyLoader
+{
+  public:
+    PropertyLoader(DetectorConstruction*);
+   ~PropertyLoader();
+
+    // returns the number of property vectors and constants loaded
+    G4int Load(const G4String& fileName);
+
+  private:
+    enum Target { kBox = 0, kWorld = 1, kSurface = 2, kNoTarget };
+
+    G4int ParseText(const char* begin, const char* end);
+    G4int ParseBinary(const char* begin, const char* end);
+
+    Target GetTarget(const G4String&) const;
+    void   AddVector(Target, const G4String& name,
+                     std::vector<G4double>& energies,
+                     std::vector<G4double>& values);
+    void   AddConstant(Target, const G4String& name, G4double value);
+
+    DetectorConstruction* fDetector;
+    G4String              fFileName;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif /*PropertyLoader_h*/
@@ -35,8 +35,18 @@
 
 #include "G4OpBoundaryProcess.hh"
 #include "G4Run.hh"
+#include "G4ThreeVector.hh"
+#include "StepCensus.hh"
+#include "MemoryMonitor.hh"
+#include "EventCost.hh"
+#include "PerfCounters.hh"
+#include "DetectorTally.hh"
+#include "Efficiencies.hh"
+
+#include <cstdint>
 
 class G4ParticleDefinition;
+class RunSummary;
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 class Run : public G4Run
@@ -133,9 +143,47 @@ class Run : public G4Run
 
     void AddDichroic(void) {fBoundaryProcs[Dichroic] += 1;}
 
+    // work done, for throughput reports
+    void AddStep() {fStepCount += 1;}
+    void AddTrackedPhoton() {fTrackedPhotons += 1;}
+    // once per photon, at its first step into a readout plane
+    void AddDetectedPhoton() {fDetectedPhotons += 1;}
+    G4long GetStepCount() const {return fStepCount;}
+    G4long GetTrackedPhotons() const {return fTrackedPhotons;}
+    StepCensus& GetCensus() {return fCensus;}
+    MemoryMonitor& GetMemoryMonitor() {return fMemory;}
+    EventCost& GetEventCost() {return fEventCost;}
+    PerfCounters& GetPerfCounters() {return fPerf;}
+    const PerfCounters& GetPerfCounters() const {return fPerf;}
+    DetectorTally& GetDetectorTally() {return fDetectorTally;}
+
+    // end of event: updates the efficiencies with the counts so far;
+    // true when the /opnovice2/run/beamUntil precision is reached
+    G4bool EndEvent();
+
+    // ntuple rows as an order-independent digest, so runs with different
+    // thread counts or shards can be compared without sorting the hits
+    void AddHit(G4long event, G4int track, G4int pdg, G4int detector,
+                const G4ThreeVector& position, G4double time);
+    G4long GetHitCount() const {return fHitCount;}
+    uint64_t GetHitDigest() const {return fHitDigest;}
+
+    G4int GetCerenkovCount() const {return fCerenkovCount;}
+    G4int GetScintillationCount() const {return fScintCount;}
+    G4int GetRayleighCount() const {return fRayleighCount;}
+    G4int GetOpAbsorption() const {return fOpAbsorption;}
+    G4int GetOpAbsorptionPrior() const {return fOpAbsorptionPrior;}
+    G4int GetTotalSurface() const {return fTotalSurface;}
+    G4int GetBoundaryProcessCount(G4OpBoundaryProcessStatus status) const
+      {return fBoundaryProcs[status];}
+
     virtual void Merge(const G4Run*);
 
     void EndOfRun();
+    // raw counters on one line, for bench/reproducibility.py
+    void PrintCounters() const;
+    // the content of EndOfRun as data
+    void FillSummary(RunSummary&) const;
 
   private:
     // primary particle
@@ -162,6 +210,18 @@ class Run : public G4Run
 
     G4int fTotalSurface;
 
+    G4long fStepCount;
+    G4long fTrackedPhotons;
+    G4long fDetectedPhotons;
+    StepCensus fCensus;
+    MemoryMonitor fMemory;
+    EventCost fEventCost;
+    PerfCounters fPerf;
+    DetectorTally fDetectorTally;
+    Efficiencies fEfficiencies;
+    G4long fHitCount;
+    uint64_t fHitDigest;
+
 };
 
 
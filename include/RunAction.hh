@@ -11,6 +11,7 @@ class Run;
 class HistoManager;
 class PrimaryGeneratorAction;
 class B5EventAction;
+class RunMessenger;
 
 class RunAction : public G4UserRunAction
 {
@@ -24,11 +25,16 @@ public:
   virtual void EndOfRunAction(const G4Run*);
 
 private:
+  // master: the run summary as JSON/CSV next to the analysis file
+  void WriteSummary(const G4Run*);
+
   G4Timer* fTimer;
   Run* fRun;
   HistoManager* fHistoManager;
   PrimaryGeneratorAction* fPrimary;
   B5EventAction* fEventAction;
+  G4double fStartupTime;
+  RunMessenger* fMessenger;
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,91 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/include/RunMessenger.hh
+/// \brief Definition of the RunMessenger class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef RunMessenger_h
+#define RunMessenger_h 1
+
+#include "globals.hh"
+#include "G4UImessenger.hh"
+
+class G4UIdirectory;
+class G4UIcommand;
+class G4UIcmdWithABool;
+class G4UIcmdWithAString;
+class G4UIcmdWithAnInteger;
+class G4UIcmdWithADouble;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+// Commands of /opnovice2/run/. They set process-wide settings, kept in
+// static variables of the classes they configure, and are not broadcast:
+// the master writes the settings between runs and the workers only read
+// them in their event loops. Those start after the master's begin of run,
+// so neither the settings nor the run state the master resets there
+// need locking.
+
+class RunMessenger: public G4UImessenger
+{
+  public:
+    RunMessenger();
+   ~RunMessenger();
+
+    virtual void SetNewValue(G4UIcommand*, G4String);
+
+  private:
+    G4UIdirectory*             fRunDir;
+    G4UIcmdWithABool*          fStageTimersCmd;
+    G4UIcmdWithABool*          fCensusCmd;
+    G4UIcmdWithAString*        fCensusFileCmd;
+    G4UIcmdWithABool*          fMemoryCmd;
+    G4UIcmdWithAnInteger*      fStackBudgetCmd;
+    G4UIcmdWithADouble*        fRSSBudgetCmd;
+    G4UIcmdWithADouble*        fAllocatorBudgetCmd;
+    G4UIcmdWithAnInteger*      fNtupleRowBudgetCmd;
+    G4UIcmdWithADouble*        fSlowPercentileCmd;
+    G4UIcmdWithAnInteger*      fWorstEventsCmd;
+    G4UIcmdWithADouble*        fProgressCmd;
+    G4UIcmdWithAString*        fProgressFileCmd;
+    G4UIcmdWithABool*          fPerfCountersCmd;
+    G4UIcmdWithABool*          fPerfSectionsCmd;
+    G4UIcmdWithAnInteger*      fEventSeedCmd;
+    G4UIcmdWithAnInteger*      fEventOffsetCmd;
+    G4UIcmdWithAString*        fSummaryFormatCmd;
+    G4UIcommand*               fTimeSpectrumCmd;
+    G4UIcommand*               fWavelengthSpectrumCmd;
+    G4UIcmdWithAString*        fSpectraFileCmd;
+    G4UIcommand*               fBeamUntilCmd;
+    G4UIcmdWithAnInteger*      fBatchSizeCmd;
+    G4UIcmdWithABool*          fPhotonHistoryCmd;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
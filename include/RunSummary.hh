@@ -0,0 +1,92 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/include/RunSummary.hh
+/// \brief Definition of the RunSummary class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef RunSummary_h
+#define RunSummary_h 1
+
+#include "globals.hh"
+
+#include <vector>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+// The end-of-run summary as data: configuration, timing, counters,
+// averages, boundary processes, event times and hardware counters,
+// filled by the master's RunAction and Run and written next to the
+// analysis file as <file>_run<R>.json and/or .csv. Entries keep their
+// order; the JSON groups them by section, the CSV has one header line
+// with section.key columns and one line of values, so the summaries of a
+// sweep can be concatenated. Keys are only ever added, never renamed or
+// removed, without raising kVersion.
+
+class RunSummary
+{
+  public:
+    static const G4int kVersion = 1;
+
+    // none, json, csv or both
+    static void SetFormat(const G4String&);
+    static const G4String& GetFormat();
+
+    RunSummary();
+   ~RunSummary();
+
+    void Add(const G4String& section, const G4String& key, G4double);
+    void Add(const G4String& section, const G4String& key, G4long);
+    void Add(const G4String& section, const G4String& key, G4int);
+    void Add(const G4String& section, const G4String& key, G4bool);
+    void Add(const G4String& section, const G4String& key, const G4String&);
+    void Add(const G4String& section, const G4String& key, const char*);
+    // JSON null, an empty CSV field
+    void AddNull(const G4String& section, const G4String& key);
+
+    // analysisFile may carry an extension, which is dropped
+    void Write(const G4String& analysisFile, G4int runID) const;
+
+  private:
+    struct Entry {
+      G4String section;
+      G4String key;
+      G4String value;   // formatted, without quotes
+      G4bool   quoted;
+    };
+
+    void AddEntry(const G4String& section, const G4String& key,
+                  const G4String& value, G4bool quoted);
+    G4bool WriteJSON(const G4String& fileName) const;
+    G4bool WriteCSV(const G4String& fileName) const;
+
+    std::vector<Entry> fEntries;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif /*RunSummary_h*/
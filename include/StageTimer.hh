@@ -0,0 +1,111 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/include/StageTimer.hh
+/// \brief Definition of the StageTimer class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef StageTimer_h
+#define StageTimer_h 1
+
+#include "globals.hh"
+
+#include <chrono>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+// Cycle-counter timers for the stages of our own user actions, so their
+// share of the run time can be told apart from Geant4 tracking. Counts
+// are thread-local and exclusive: a nested stage pauses the enclosing
+// one. Instrumentation points use OPNOVICE2_STAGE_TIMER(stage), which
+// expands to nothing unless the build defines OPNOVICE2_STAGE_TIMERS
+// (CMake option of the same name); when compiled in, the timers are
+// switched on and off with /opnovice2/run/stageTimers.
+
+class StageTimer
+{
+  public:
+    enum Stage {
+      kNtuple,        // hit ntuple filling
+      kBoundary,      // optical boundary accounting
+      kHistograms,    // direction histograms at the first boundary
+      kSecondaries,   // photon yield and secondary loop
+      kTrackInfo,     // TrackInformation set-up and propagation
+      kEventBegin,
+      kEventEnd,
+      kNStages
+    };
+
+    class Scope
+    {
+      public:
+        explicit Scope(Stage);
+       ~Scope();
+      private:
+        Stage    fStage;
+        uint64_t fStart;
+        Scope*   fParent;
+        G4bool   fActive;
+    };
+
+    static void   SetEnabled(G4bool);
+    static G4bool IsEnabled();
+    static G4bool IsCompiled();
+
+    // per thread: clear at begin of run, print the breakdown at the end
+    static void Reset();
+    static void Report();
+
+    static const char* GetStageName(Stage);
+
+    // time stamp counter; nanoseconds where there is none
+    static inline uint64_t Cycles()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+      return __rdtsc();
+#else
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+};
+
+#ifdef OPNOVICE2_STAGE_TIMERS
+#define OPNOVICE2_STAGE_TIMER(stage) \
+  StageTimer::Scope stageTimerScope(StageTimer::stage)
+#else
+#define OPNOVICE2_STAGE_TIMER(stage)
+#endif
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif /*StageTimer_h*/
@@ -0,0 +1,106 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/include/StepCensus.hh
+/// \brief Definition of the StepCensus class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef StepCensus_h
+#define StepCensus_h 1
+
+#include "globals.hh"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+class G4Step;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+// Steps, tracks and CPU time per (particle, logical volume, process
+// limiting the step). Each Run holds one census, filled by its thread's
+// SteppingAction and merged into the master with the run. Particles,
+// volumes and processes are numbered as they are first seen and the
+// cells are kept in a table keyed by the three indices; the time of a
+// step is the cycle count since the previous step of the same track.
+// Off unless /opnovice2/run/census is set.
+
+class StepCensus
+{
+  public:
+    StepCensus();
+   ~StepCensus();
+
+    static void   SetEnabled(G4bool);
+    static G4bool IsEnabled();
+    // CSV file written by the master at end of run; empty for none
+    static void   SetOutputFile(const G4String&);
+    static const G4String& GetOutputFile();
+
+    // restarts the step clock of this thread for a new track
+    static void StartTrack();
+    void AddStep(const G4Step*);
+
+    void Merge(const StepCensus&);
+    void Print(G4int maxRows) const;
+    void Write(const G4String& fileName) const;
+
+  private:
+    struct Cell {
+      G4long   steps;
+      G4long   tracks;
+      uint64_t cycles;
+    };
+
+    struct Dictionary {
+      std::vector<G4String> names;
+      std::unordered_map<const void*, G4int> index;   // filling thread
+      G4int Find(const void* key, const G4String& name);
+      G4int Find(const G4String& name);
+    };
+
+    static uint64_t Key(G4int particle, G4int volume, G4int process)
+    { return (uint64_t(particle) << 40) | (uint64_t(volume) << 20)
+             | uint64_t(process); }
+
+    std::vector<std::pair<uint64_t, Cell> > SortedCells() const;
+    G4double SecondsPerCycle() const;
+
+    Dictionary fParticles;
+    Dictionary fVolumes;
+    Dictionary fProcesses;
+    std::unordered_map<uint64_t, Cell> fCells;
+
+    // calibration of the cycle counter over the run
+    G4double fStartTime;
+    uint64_t fStartCycles;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif /*StepCensus_h*/
@@ -36,6 +36,8 @@
 #include "globals.hh"
 
 class B5EventAction;
+class DetectorConstruction;
+class G4OpBoundaryProcess;
 
 class SteppingAction : public G4UserSteppingAction
 {
@@ -49,6 +51,9 @@ public:
 private:
   G4int fVerbose;
   B5EventAction *fEvtAction;
+  const DetectorConstruction* fDetector;
+  // looked up once instead of at every boundary step
+  G4OpBoundaryProcess* fBoundary;
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
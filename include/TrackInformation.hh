@@ -38,10 +38,23 @@
 #include "G4Track.hh"
 #include "G4Allocator.hh"
 #include "G4VUserTrackInformation.hh"
+#include "G4OpBoundaryProcess.hh"
+
+#include <cstdint>
+
+// Besides the first-crossing flag, each track carries a packed history
+// that SteppingAction updates step by step: the process that created the
+// photon, the number of reflections and total internal reflections, the
+// path length in the tank and the status at the first boundary. With
+// /opnovice2/run/photonHistory the history of the photons reaching a
+// readout plane is written to the "history" ntuple. The object must stay
+// within one cache line, it is allocated for every track.
 
 class TrackInformation : public G4VUserTrackInformation 
 {
 public:
+  enum Creator { kPrimary = 0, kCerenkov, kScintillation, kWLS, kOther };
+
   TrackInformation();
   TrackInformation(const G4Track* aTrack);
   TrackInformation(const TrackInformation* aTrackInfo);
@@ -52,17 +65,46 @@ public:
 
   TrackInformation& operator =(const TrackInformation& right);
   
+  // resets the history at the start of tracking
   void SetSourceTrackInformation(const G4Track* aTrack);
   virtual void Print() const;
 
+  static void   SetWriteHistory(G4bool);
+  static G4bool GetWriteHistory();
+
 public:
   inline G4bool GetIsFirstTankX() const {return fFirstTankX;}
   inline void   SetIsFirstTankX(G4bool b) {fFirstTankX = b;}
 
+  inline Creator  GetCreator() const {return Creator(fCreator);}
+  inline G4int    GetBounces() const {return fBounces;}
+  inline G4int    GetTotalInternalReflections() const {return fTIRs;}
+  inline G4double GetTankPath() const {return fTankPath;}
+  inline G4OpBoundaryProcessStatus GetFirstBoundaryStatus() const
+    {return G4OpBoundaryProcessStatus(fFirstBoundary);}
+
+  inline void AddTankPath(G4double length) {fTankPath += length;}
+  inline void SetFirstBoundaryStatus(G4OpBoundaryProcessStatus status)
+    {fFirstBoundary = uint8_t(status);}
+  inline void AddBoundary(G4OpBoundaryProcessStatus);
+
+  // reached a readout plane; a photon may do so in several steps
+  inline G4bool IsDetected() const {return fDetected;}
+  inline void   SetDetected() {fDetected = true;}
+
 private:
+  G4float   fTankPath;        // internal units, float is precise enough
+  uint16_t  fBounces;         // the counters saturate
+  uint16_t  fTIRs;
+  uint8_t   fCreator;
+  uint8_t   fFirstBoundary;
   G4bool    fFirstTankX;
+  G4bool    fDetected;
 };
 
+static_assert(sizeof(TrackInformation) <= 64,
+              "TrackInformation must fit in a cache line");
+
 extern G4ThreadLocal
  G4Allocator<TrackInformation> * aTrackInformationAllocator;
 
@@ -76,5 +118,17 @@ inline void* TrackInformation::operator new(size_t)
 inline void TrackInformation::operator delete(void *aTrackInfo)
 { aTrackInformationAllocator->FreeSingle((TrackInformation*)aTrackInfo);}
 
-#endif
+inline void TrackInformation::AddBoundary(G4OpBoundaryProcessStatus status)
+{
+  // every reflection is a bounce, also those of the LUT surfaces
+  G4bool reflected = status == FresnelReflection ||
+    status == TotalInternalReflection || status == LambertianReflection ||
+    status == LobeReflection || status == SpikeReflection ||
+    status == BackScattering ||
+    (status >= PolishedLumirrorAirReflection &&
+     status <= GroundVM2000GlueReflection);
+  if (reflected && fBounces < UINT16_MAX) ++fBounces;
+  if (status == TotalInternalReflection && fTIRs < UINT16_MAX) ++fTIRs;
+}
 
+#endif
@@ -42,7 +42,6 @@ public:
   virtual ~TrackingAction(){};
    
   virtual void PreUserTrackingAction(const G4Track*);
-  virtual void PostUserTrackingAction(const G4Track*);
   
 };
 
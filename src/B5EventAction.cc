@@ -1,4 +1,9 @@
 #include "B5EventAction.hh"
+#include "StageTimer.hh"
+#include "ProgressMonitor.hh"
+#include "PerfCounters.hh"
+#include "EventSeeder.hh"
+#include "Run.hh"
 
 #include "G4Event.hh"
 #include "G4RunManager.hh"
@@ -19,9 +24,17 @@ B5EventAction::~B5EventAction()
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-void B5EventAction::BeginOfEventAction(const G4Event*)
+void B5EventAction::BeginOfEventAction(const G4Event* event)
 {
-  eventId++;
+  OPNOVICE2_STAGE_TIMER(kEventBegin);
+  PerfCounters::Scope perfScope(PerfCounters::kEventActions);
+  // global number, the same whatever thread or shard runs the event
+  eventId = EventSeeder::GetGlobalEventID(event);
+  Run* run = static_cast<Run*>(
+    G4RunManager::GetRunManager()->GetNonConstCurrentRun());
+  if (MemoryMonitor::IsEnabled()) run->GetMemoryMonitor().BeginEvent();
+  run->GetEventCost().BeginEvent(run->GetStepCount(),
+                                 run->GetTrackedPhotons());
   //G4cout<<"at event "<<eventId<<G4endl;
 }     
 
@@ -29,6 +42,24 @@ void B5EventAction::BeginOfEventAction(const G4Event*)
 
 void B5EventAction::EndOfEventAction(const G4Event* event)
 {
+  OPNOVICE2_STAGE_TIMER(kEventEnd);
+  Run* run = static_cast<Run*>(
+    G4RunManager::GetRunManager()->GetNonConstCurrentRun());
+  {
+    // closed before the event counts are taken below
+    PerfCounters::Scope perfScope(PerfCounters::kEventActions);
+    run->GetEventCost().EndEvent(event, run->GetStepCount(),
+                                 run->GetTrackedPhotons());
+    if (MemoryMonitor::IsEnabled()) {
+      run->GetMemoryMonitor().EndEvent(event->GetEventID());
+    }
+    // the run counts this event only after the end-of-event action
+    ProgressMonitor::Publish(run->GetNumberOfEvent() + 1,
+                             run->GetStepCount(), run->GetTrackedPhotons());
+    // soft abort: this event is kept, the thread stops its event loop
+    if (run->EndEvent()) G4RunManager::GetRunManager()->AbortRun(true);
+  }
+  run->GetPerfCounters().EndEvent();
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,181 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/src/CerenkovSource.cc
+/// \brief Implementation of the CerenkovSource class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "CerenkovSource.hh"
+#include "PhotonSampling.hh"
+
+#include "G4Event.hh"
+#include "G4OpticalPhoton.hh"
+#include "G4Poisson.hh"
+#include "G4PrimaryParticle.hh"
+#include "G4PrimaryVertex.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4SystemOfUnits.hh"
+#include "Randomize.hh"
+
+#include <algorithm>
+
+namespace {
+  const G4int kNBins = 256;
+  // uniform numbers per photon: bin, energy, position, azimuth
+  const G4int kRandomsPerPhoton = 4;
+  // Frank-Tamm factor for unit charge, as in G4Cerenkov
+  const G4double kRfact = 369.81/(eV*cm);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+CerenkovSource::CerenkovSource()
+  : fBeta(0.),
+    fSegment(1.*cm),
+    fNPhotons(0),
+    fEmin(0.),
+    fBinWidth(0.),
+    fMeanPerLength(0.)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+CerenkovSource::~CerenkovSource()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void CerenkovSource::BuildTables(const G4MaterialPropertyVector* rindex)
+{
+  fRindex.clear();
+  fProb.clear();
+  fAlias.clear();
+  fMeanPerLength = 0.;
+  if (!rindex || rindex->GetVectorLength() < 2 || fBeta <= 0.) return;
+
+  fEmin     = rindex->GetMinLowEdgeEnergy();
+  fBinWidth = (rindex->GetMaxLowEdgeEnergy() - fEmin)/kNBins;
+  fRindex.resize(kNBins + 1);
+  for (G4int i = 0; i <= kNBins; ++i) {
+    fRindex[i] = rindex->Value(fEmin + i*fBinWidth);
+  }
+
+  // photon yield per bin, dN/dE ~ 1 - 1/(beta n)^2 above threshold
+  std::vector<G4double> weight(kNBins);
+  G4double total = 0.;
+  for (G4int i = 0; i < kNBins; ++i) {
+    G4double w = 0.;
+    for (G4int k = i; k <= i + 1; ++k) {
+      const G4double bn = fBeta*fRindex[k];
+      if (bn > 1.) w += 0.5*(1. - 1./(bn*bn));
+    }
+    weight[i] = w;
+    total += w;
+  }
+  if (total <= 0.) {
+    G4ExceptionDescription ed;
+    ed << "No Cerenkov light for beta = " << fBeta
+       << ": beta*n stays below 1 over the RINDEX range";
+    G4Exception("CerenkovSource::BuildTables", "OpNovice2_018",
+                JustWarning, ed);
+    return;
+  }
+  fMeanPerLength = kRfact*total*fBinWidth;
+
+  // Vose's alias method
+  fProb.resize(kNBins);
+  fAlias.assign(kNBins, 0);
+  std::vector<G4int> small, large;
+  for (G4int i = 0; i < kNBins; ++i) {
+    fProb[i] = weight[i]*kNBins/total;
+    (fProb[i] < 1. ? small : large).push_back(i);
+  }
+  while (!small.empty() && !large.empty()) {
+    const G4int s = small.back(); small.pop_back();
+    const G4int l = large.back();
+    fAlias[s] = l;
+    fProb[l] -= 1. - fProb[s];
+    if (fProb[l] < 1.) { large.pop_back(); small.push_back(l); }
+  }
+  // leftovers are 1 up to rounding
+  for (G4int i : small) fProb[i] = 1.;
+  for (G4int i : large) fProb[i] = 1.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void CerenkovSource::Generate(G4Event* anEvent, const G4ThreeVector& origin,
+                              const G4ThreeVector& axis, G4double t0)
+{
+  if (fProb.empty()) return;
+
+  const G4int n = (fNPhotons > 0) ? fNPhotons
+                                  : G4Poisson(GetMeanNumberOfPhotons());
+  if (n <= 0) return;
+  fRandom.resize(n*kRandomsPerPhoton);
+  G4Random::getTheEngine()->flatArray(n*kRandomsPerPhoton, fRandom.data());
+
+  G4ThreeVector b1, b2;
+  PhotonSampling::TransverseBasis(axis, b1, b2);
+  const G4double speed = fBeta*c_light;
+  G4ParticleDefinition* photon = G4OpticalPhoton::Definition();
+
+  for (G4int i = 0; i < n; ++i) {
+    const G4double* u = &fRandom[i*kRandomsPerPhoton];
+
+    // alias draw: one number picks the bin and the acceptance
+    const G4double x = u[0]*kNBins;
+    G4int bin = std::min((G4int)x, kNBins - 1);
+    if (x - bin >= fProb[bin]) bin = fAlias[bin];
+
+    const G4double f = u[1];
+    const G4double energy = fEmin + (bin + f)*fBinWidth;
+    const G4double rindex = fRindex[bin] + f*(fRindex[bin+1] - fRindex[bin]);
+    // an edge of the bin may lie below threshold
+    const G4double cosTheta = std::min(1./(fBeta*rindex), 1.);
+    const G4double sinTheta = std::sqrt((1. - cosTheta)*(1. + cosTheta));
+
+    const G4double phi = twopi*u[3];
+    const G4ThreeVector radial = std::cos(phi)*b1 + std::sin(phi)*b2;
+    const G4ThreeVector dir = cosTheta*axis + sinTheta*radial;
+    // in the plane of the particle and the photon, as in G4Cerenkov
+    const G4ThreeVector pol = cosTheta*radial - sinTheta*axis;
+
+    const G4double s = u[2]*fSegment;
+    G4PrimaryVertex* vertex =
+      new G4PrimaryVertex(origin + s*axis, t0 + s/speed);
+    G4PrimaryParticle* particle = new G4PrimaryParticle(photon);
+    particle->SetMomentumDirection(dir);
+    particle->SetKineticEnergy(energy);
+    particle->SetPolarization(pol);
+    vertex->SetPrimary(particle);
+    anEvent->AddPrimaryVertex(vertex);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
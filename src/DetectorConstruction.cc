@@ -33,6 +33,8 @@
 
 #include "DetectorConstruction.hh"
 #include "DetectorMessenger.hh"
+#include "PropertyLoader.hh"
+#include "PhysicsList.hh"
 
 #include "G4NistManager.hh"
 #include "G4Material.hh"
@@ -44,8 +46,90 @@
 #include "G4LogicalVolume.hh"
 #include "G4ThreeVector.hh"
 #include "G4PVPlacement.hh"
+#include "G4PVReplica.hh"
+#include "G4VTouchable.hh"
+#include "G4LogicalVolumeStore.hh"
+#include "G4PhysicalVolumeStore.hh"
+#include "G4Region.hh"
+#include "G4ProductionCuts.hh"
+#include "G4RegionStore.hh"
+#include "G4UserLimits.hh"
+#include "G4RunManagerKernel.hh"
+#include "G4VUserPhysicsList.hh"
+#include "G4UnitsTable.hh"
 #include "G4SystemOfUnits.hh"
 
+#include <sstream>
+
+#ifdef G4LIB_USE_GDML
+#include "G4GDMLParser.hh"
+#endif
+
+namespace {
+  // first placement of a logical volume; replicas are one placement
+  G4VPhysicalVolume* FindPlacement(const G4LogicalVolume* lv)
+  {
+    for (G4VPhysicalVolume* pv : *G4PhysicalVolumeStore::GetInstance()) {
+      if (pv->GetLogicalVolume() == lv) return pv;
+    }
+    return nullptr;
+  }
+
+  // a step can go from one volume into the other
+  G4bool Touch(const G4VPhysicalVolume* pv1, const G4VPhysicalVolume* pv2)
+  {
+    return pv1->GetMotherLogical() == pv2->GetLogicalVolume() ||
+           pv2->GetMotherLogical() == pv1->GetLogicalVolume() ||
+           (pv1->GetMotherLogical() &&
+            pv1->GetMotherLogical() == pv2->GetMotherLogical());
+  }
+
+  G4bool IsAncestor(const G4LogicalVolume* lv, const G4VPhysicalVolume* pv)
+  {
+    const G4LogicalVolume* mother = pv->GetMotherLogical();
+    while (mother) {
+      if (mother == lv) return true;
+      const G4VPhysicalVolume* placement = FindPlacement(mother);
+      mother = placement ? placement->GetMotherLogical() : nullptr;
+    }
+    return false;
+  }
+
+  // names as taken by the /opnovice2/surface* commands
+  const char* kModelNames[] = {"glisur", "unified", "LUT", "DAVIS", "dichroic"};
+
+  const char* kFinishNames[] = {
+    "polished", "polishedfrontpainted", "polishedbackpainted",
+    "ground", "groundfrontpainted", "groundbackpainted",
+    "polishedlumirrorair", "polishedlumirrorglue", "polishedair",
+    "polishedteflonair", "polishedtioair", "polishedtyvekair",
+    "polishedvm2000air", "polishedvm2000glue",
+    "etchedlumirrorair", "etchedlumirrorglue", "etchedair",
+    "etchedteflonair", "etchedtioair", "etchedtyvekair",
+    "etchedvm2000air", "etchedvm2000glue",
+    "groundlumirrorair", "groundlumirrorglue", "groundair",
+    "groundteflonair", "groundtioair", "groundtyvekair",
+    "groundvm2000air", "groundvm2000glue",
+    "Rough_LUT", "RoughTeflon_LUT", "RoughESR_LUT", "RoughESRGrease_LUT",
+    "Polished_LUT", "PolishedTeflon_LUT", "PolishedESR_LUT",
+    "PolishedESRGrease_LUT", "Detector_LUT"
+  };
+
+  const char* kTypeNames[] = {
+    "dielectric_metal", "dielectric_dielectric", "dielectric_LUT",
+    "dielectric_LUTDAVIS", "dielectric_dichroic", "firsov", "x_ray"
+  };
+
+  template <size_t N>
+  G4String EnumName(const char* (&names)[N], G4int value)
+  {
+    if (value >= 0 && value < G4int(N)) return names[value];
+    std::ostringstream unknown;
+    unknown << "unknown (" << value << ")";
+    return unknown.str();
+  }
+}
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 DetectorConstruction::DetectorConstruction()
@@ -58,23 +142,38 @@ DetectorConstruction::DetectorConstruction()
 
   fTank = nullptr;
 
+  fNBarsX  = fNBarsZ = 1;
+  fBarGap  = 1*mm;
+
   fTankMPT    = new G4MaterialPropertiesTable();
   fWorldMPT   = new G4MaterialPropertiesTable();
-  fSurfaceMPT = new G4MaterialPropertiesTable();
 
-  fSurface = new G4OpticalSurface("Surface");
-  fSurface->SetType(dielectric_dielectric);
-  fSurface->SetFinish(ground);
-  fSurface->SetModel(unified);
-  fSurface->SetMaterialPropertiesTable(fSurfaceMPT);
+  fSurface    = nullptr;
+  fSurfaceMPT = nullptr;
+  CreateSurface("Surface");
   
   fTank_LV  = nullptr;
   fWorld_LV = nullptr;
+  fWorld_PV = nullptr;
 
   fTankMaterial  = G4NistManager::Instance()->FindOrBuildMaterial("G4_WATER");
   fWorldMaterial = G4NistManager::Instance()->FindOrBuildMaterial("G4_Galactic");
   fDetMaterial = G4NistManager::Instance()->FindOrBuildMaterial("G4_Pb");
 
+  // the root volumes are added once the geometry is built
+  fTankRegion     = new G4Region("TankRegion");
+  fDetectorRegion = new G4Region("DetectorRegion");
+  const char* regionNames[kNRegions] = {"Tank", "Detector", "World"};
+  for (G4int i = 0; i < kNRegions; ++i) {
+    fRegionLimits[i].name           = regionNames[i];
+    fRegionLimits[i].maxTrackLength = DBL_MAX;
+    fRegionLimits[i].maxTime        = DBL_MAX;
+    fRegionLimits[i].minEkin        = 0.;
+    fRegionLimits[i].limits         = new G4UserLimits();
+  }
+  fTankRegion->SetUserLimits(fRegionLimits[kTankRegion].limits);
+  fDetectorRegion->SetUserLimits(fRegionLimits[kDetectorRegion].limits);
+
   fDetectorMessenger = new DetectorMessenger(this);
 }
 
@@ -89,6 +188,7 @@ DetectorConstruction::~DetectorConstruction()
 
 G4VPhysicalVolume* DetectorConstruction::Construct()
 {
+  if (!fGDMLFile.empty()) return ConstructFromGDML();
 
   /*eicdirc additions*/
   static const G4double LambdaE = 2.0 * 3.14159265358979323846 * 1.973269602e-16 * m * GeV;
@@ -153,14 +253,56 @@ G4VPhysicalVolume* DetectorConstruction::Construct()
   fWorldMaterial->SetMaterialPropertiesTable(fWorldMPT);
 
   // ------------- Volumes --------------
-  // The experimental Hall
-  G4Box* world_box = new G4Box("World", fExpHall_x, fExpHall_y, fExpHall_z);
+  // The bars and their readout planes are grouped in cells;
+  // an array of bars is built as replicas of one cell.
+  G4bool isArray = (fNBarsX*fNBarsZ > 1);
+
+  G4double cell_x = fTank_x + 0.5*fBarGap;
+  G4double cell_y = fTank_y + 2*mm;
+  G4double cell_z = fTank_z + 0.5*fBarGap;
+
+  // The experimental Hall, enlarged to hold the array if needed
+  G4double hall_x = fExpHall_x;
+  G4double hall_y = fExpHall_y;
+  G4double hall_z = fExpHall_z;
+  if (isArray) {
+    hall_x = std::max(hall_x, fNBarsX*cell_x + 1*cm);
+    hall_y = std::max(hall_y, cell_y + 1*cm);
+    hall_z = std::max(hall_z, fNBarsZ*cell_z + 1*cm);
+  }
+  G4Box* world_box = new G4Box("World", hall_x, hall_y, hall_z);
 
   fWorld_LV
     = new G4LogicalVolume(world_box, fWorldMaterial, "World", 0, 0, 0);
 
   G4VPhysicalVolume* world_PV
     = new G4PVPlacement(0, G4ThreeVector(), fWorld_LV, "World", 0, false, 0);
+  fWorld_PV = world_PV;
+
+  // Mother of one bar and its readout planes
+  G4LogicalVolume* barMother_LV = fWorld_LV;
+  if (isArray) {
+    G4Box* array_box = new G4Box("BarArray", fNBarsX*cell_x, cell_y,
+                                 fNBarsZ*cell_z);
+    G4LogicalVolume* array_LV
+      = new G4LogicalVolume(array_box, fWorldMaterial, "BarArray", 0, 0, 0);
+    new G4PVPlacement(0, G4ThreeVector(), array_LV, "BarArray",
+                      fWorld_LV, false, 0);
+
+    // columns along x, cells along z
+    G4Box* column_box = new G4Box("BarColumn", cell_x, cell_y,
+                                  fNBarsZ*cell_z);
+    G4LogicalVolume* column_LV
+      = new G4LogicalVolume(column_box, fWorldMaterial, "BarColumn", 0, 0, 0);
+    new G4PVReplica("BarColumn", column_LV, array_LV,
+                    kXAxis, fNBarsX, 2*cell_x);
+
+    G4Box* cell_box = new G4Box("BarCell", cell_x, cell_y, cell_z);
+    barMother_LV
+      = new G4LogicalVolume(cell_box, fWorldMaterial, "BarCell", 0, 0, 0);
+    new G4PVReplica("BarCell", barMother_LV, column_LV,
+                    kZAxis, fNBarsZ, 2*cell_z);
+  }
 
   // The tank
   G4Box* tank_box = new G4Box("Tank", fTank_x, fTank_y, fTank_z);
@@ -170,38 +312,433 @@ G4VPhysicalVolume* DetectorConstruction::Construct()
 
   fTank
     = new G4PVPlacement(0, G4ThreeVector(), fTank_LV, "Tank",
-                        fWorld_LV, false, 0);
+                        barMother_LV, false, 0);
 
+  // The readout planes; the copy number identifies the plane
   G4Box* detBox = new G4Box("detSolid", fTank_x, 1*mm, fTank_z);
   
   fdet1_LV = new G4LogicalVolume(detBox, fDetMaterial, "det1", 0,0, 0);
   fdet2_LV = new G4LogicalVolume(detBox, fDetMaterial, "det2", 0,0, 0);
 
-  fdet1 = new G4PVPlacement(0, G4ThreeVector(0, fTank_y+1*mm,0),fdet1_LV, "det1",fWorld_LV,false,0);
-  fdet2 = new G4PVPlacement(0, G4ThreeVector(0,-fTank_y-1*mm,0),fdet1_LV, "det2",fWorld_LV,false,0);
+  fdet1 = new G4PVPlacement(0, G4ThreeVector(0, fTank_y+1*mm,0),fdet1_LV, "det1",barMother_LV,false,1);
+  fdet2 = new G4PVPlacement(0, G4ThreeVector(0,-fTank_y-1*mm,0),fdet1_LV, "det2",barMother_LV,false,2);
+  fReadoutLVs.assign(1, fdet1_LV);
 
+  // ------------- Regions --------------
+  SetupRegions();
 
-  /*
-  // ------------- Surface --------------
+  // ------------- Surfaces --------------
+  for (const SurfaceBinding& b : fSurfaceBindings) ApplySurfaceBinding(b);
 
-  G4LogicalBorderSurface* surface =
-          new G4LogicalBorderSurface("Surface",
-                                 fTank, world_PV, fSurface);
+  return world_PV;
+}
 
-  G4OpticalSurface* opticalSurface = dynamic_cast <G4OpticalSurface*>
-        (surface->GetSurface(fTank,world_PV)->GetSurfaceProperty());
-  G4cout << "******  opticalSurface->DumpInfo:" << G4endl;
-  if (opticalSurface) { opticalSurface->DumpInfo(); }
-  G4cout << "******  end of opticalSurface->DumpInfo" << G4endl;
-  */
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+G4VPhysicalVolume* DetectorConstruction::ConstructFromGDML()
+{
+#ifdef G4LIB_USE_GDML
+  G4GDMLParser parser;
+  // Schema validation and the overlap check of every placement dominate
+  // the read time of large files; both are skipped here, the geometry
+  // is expected to have been checked when the file was produced.
+  parser.SetOverlapCheck(false);
+  parser.Read(fGDMLFile, false);
+
+  fWorld_PV = parser.GetWorldVolume();
+  fWorld_LV = fWorld_PV->GetLogicalVolume();
+  fTank     = nullptr;
+  fTank_LV  = nullptr;
+  fReadoutLVs.clear();
+
+  // Bindings are taken from the auxiliary tags of the volumes:
+  //   <auxiliary auxtype="Role"    auxvalue="Tank"/>    radiator volume
+  //   <auxiliary auxtype="SensDet" auxvalue="Readout"/> readout plane,
+  //                                   the physvol copynumber is the plane
+  //   <auxiliary auxtype="Surface" auxvalue="Surface"/> skin surface with
+  //                                   the named surface of the registry
+  // The aux map only holds tagged volumes, so the cost does not grow
+  // with the size of the geometry.
+  const G4GDMLAuxMapType* auxMap = parser.GetAuxMap();
+  for (auto it = auxMap->begin(); it != auxMap->end(); ++it) {
+    G4LogicalVolume* lv = it->first;
+    for (const G4GDMLAuxStructType& aux : it->second) {
+      if (aux.type == "Role" && aux.value == "Tank") {
+        fTank_LV = lv;
+      }
+      else if (aux.type == "SensDet" && aux.value == "Readout") {
+        fReadoutLVs.push_back(lv);
+      }
+      else if (aux.type == "Surface") {
+        G4OpticalSurface* surface = FindSurface(aux.value);
+        if (surface) {
+          new G4LogicalSkinSurface(lv->GetName(), lv, surface);
+        }
+        else {
+          G4ExceptionDescription ed;
+          ed << "Unknown optical surface " << aux.value << " for volume "
+             << lv->GetName() << "; tag ignored.";
+          G4Exception("DetectorConstruction::ConstructFromGDML",
+                      "OpNovice2_008", JustWarning, ed);
+        }
+      }
+    }
+  }
+  if (!fTank_LV) {
+    fTank_LV = G4LogicalVolumeStore::GetInstance()->GetVolume("Tank", false);
+  }
+  for (const SurfaceBinding& b : fSurfaceBindings) ApplySurfaceBinding(b);
 
-  return world_PV;
+  // Materials without their own property table in the file take the
+  // tables filled by the /opnovice2/box* and /opnovice2/world* commands.
+  fWorldMaterial = fWorld_LV->GetMaterial();
+  if (!fWorldMaterial->GetMaterialPropertiesTable()) {
+    fWorldMaterial->SetMaterialPropertiesTable(fWorldMPT);
+  }
+  if (fTank_LV) {
+    fTankMaterial = fTank_LV->GetMaterial();
+    if (!fTankMaterial->GetMaterialPropertiesTable()) {
+      fTankMaterial->SetMaterialPropertiesTable(fTankMPT);
+    }
+  }
+
+  SetupRegions();
+
+  G4cout << "Geometry read from " << fGDMLFile << ": "
+         << fReadoutLVs.size() << " readout volume(s), tank "
+         << (fTank_LV ? fTank_LV->GetName() : G4String("not found"))
+         << G4endl;
+
+  return fWorld_PV;
+#else
+  G4ExceptionDescription ed;
+  ed << "Cannot read " << fGDMLFile
+     << ": OpNovice2 was built without GDML support.";
+  G4Exception("DetectorConstruction::ConstructFromGDML", "OpNovice2_009",
+              FatalException, ed);
+  return nullptr;
+#endif
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void DetectorConstruction::SetupRegions()
+{
+  if (fTank_LV) fTankRegion->AddRootLogicalVolume(fTank_LV);
+  for (G4LogicalVolume* lv : fReadoutLVs) {
+    fDetectorRegion->AddRootLogicalVolume(lv);
+  }
+
+  // G4UserSpecialCuts takes the limits from the logical volume of the
+  // track, so every volume gets the limits of its region. Limits that
+  // came with the geometry (e.g. from GDML) are kept.
+  for (G4LogicalVolume* lv : *G4LogicalVolumeStore::GetInstance()) {
+    if (lv->GetUserLimits()) continue;
+    if (lv == fTank_LV) {
+      lv->SetUserLimits(fRegionLimits[kTankRegion].limits);
+    }
+    else if (IsReadoutVolume(lv)) {
+      lv->SetUserLimits(fRegionLimits[kDetectorRegion].limits);
+    }
+    else {
+      lv->SetUserLimits(fRegionLimits[kWorldRegion].limits);
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+DetectorConstruction::RegionLimits*
+DetectorConstruction::FindRegionLimits(const G4String& region)
+{
+  for (G4int i = 0; i < kNRegions; ++i) {
+    if (fRegionLimits[i].name == region) return &fRegionLimits[i];
+  }
+  G4ExceptionDescription ed;
+  ed << "Unknown region " << region << "; use Tank, Detector or World.";
+  G4Exception("DetectorConstruction::FindRegionLimits", "OpNovice2_011",
+              JustWarning, ed);
+  return nullptr;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void DetectorConstruction::SetRegionCut(const G4String& region, G4double cut)
+{
+  if (!FindRegionLimits(region)) return;
+  G4VUserPhysicsList* physicsList =
+    G4RunManagerKernel::GetRunManagerKernel()->GetPhysicsList();
+  // the world keeps the default cuts, which the physics list would
+  // otherwise reset at initialization. Regions without cuts of their
+  // own inherit the default, so the tank and the readout planes are
+  // given the current default first: a World cut changes only the world.
+  if (region == "World") {
+    G4RegionStore* store = G4RegionStore::GetInstance();
+    for (G4int i = 0; i < kNRegions; ++i) {
+      if (i == kWorldRegion) continue;
+      G4String name = fRegionLimits[i].name + "Region";
+      const G4Region* other = store->GetRegion(name, false);
+      if (other && !other->GetProductionCuts()) {
+        physicsList->SetCutsForRegion(physicsList->GetDefaultCutValue(), name);
+      }
+    }
+    physicsList->SetDefaultCutValue(cut);
+  }
+  else physicsList->SetCutsForRegion(cut, region + "Region");
+  // a table cache entry chosen at initialization no longer matches
+  PhysicsList* list = dynamic_cast<PhysicsList*>(physicsList);
+  if (list) list->CutsChanged();
+  G4cout << "Production cut in " << region << " set to "
+         << G4BestUnit(cut, "Length") << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void DetectorConstruction::SetRegionMaxTrackLength(const G4String& region,
+                                                   G4double length)
+{
+  RegionLimits* r = FindRegionLimits(region);
+  if (!r) return;
+  r->maxTrackLength = length;
+  r->limits->SetUserMaxTrackLength(length);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void DetectorConstruction::SetRegionMaxTime(const G4String& region,
+                                            G4double time)
+{
+  RegionLimits* r = FindRegionLimits(region);
+  if (!r) return;
+  r->maxTime = time;
+  r->limits->SetUserMaxTime(time);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void DetectorConstruction::SetRegionMinEkin(const G4String& region,
+                                            G4double ekin)
+{
+  RegionLimits* r = FindRegionLimits(region);
+  if (!r) return;
+  r->minEkin = ekin;
+  r->limits->SetUserMinEkine(ekin);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void DetectorConstruction::PrintRegions() const
+{
+  G4RegionStore* store = G4RegionStore::GetInstance();
+  for (G4int i = 0; i < kNRegions; ++i) {
+    const RegionLimits& r = fRegionLimits[i];
+    const G4Region* region = (i == kWorldRegion)
+      ? store->GetRegion("DefaultRegionForTheWorld", false)
+      : store->GetRegion(r.name + "Region", false);
+    G4cout << r.name << ":";
+    if (region && region->GetProductionCuts()) {
+      G4cout << " cut " << G4BestUnit(
+        region->GetProductionCuts()->GetProductionCut(0), "Length");
+    }
+    G4cout << " maxTrackLength ";
+    if (r.maxTrackLength < DBL_MAX) {
+      G4cout << G4BestUnit(r.maxTrackLength, "Length");
+    }
+    else G4cout << "none";
+    G4cout << " maxTime ";
+    if (r.maxTime < DBL_MAX) G4cout << G4BestUnit(r.maxTime, "Time");
+    else G4cout << "none";
+    G4cout << " minEkin " << G4BestUnit(r.minEkin, "Energy") << G4endl;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void DetectorConstruction::WriteGDML(const G4String& fileName)
+{
+  if (!fWorld_PV) {
+    G4Exception("DetectorConstruction::WriteGDML", "OpNovice2_009",
+                JustWarning, "The geometry has not been built yet.");
+    return;
+  }
+#ifdef G4LIB_USE_GDML
+  G4GDMLParser parser;
+  // tag the volumes so that the file can be read back with the same
+  // bindings (see ConstructFromGDML)
+  G4GDMLAuxStructType aux;
+  if (fTank_LV) {
+    aux.type = "Role";
+    aux.value = "Tank";
+    parser.AddVolumeAuxiliary(aux, fTank_LV);
+  }
+  for (const G4LogicalVolume* lv : fReadoutLVs) {
+    aux.type = "SensDet";
+    aux.value = "Readout";
+    parser.AddVolumeAuxiliary(aux, lv);
+  }
+  // plain names (no pointer suffix) keep the tags and the readout
+  // lookup by name meaningful when the file is read back
+  parser.Write(fileName, fWorld_PV, false);
+  G4cout << "Geometry written to " << fileName << G4endl;
+#else
+  G4ExceptionDescription ed;
+  ed << "Cannot write " << fileName
+     << ": OpNovice2 was built without GDML support.";
+  G4Exception("DetectorConstruction::WriteGDML", "OpNovice2_009",
+              JustWarning, ed);
+#endif
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void DetectorConstruction::SetBarArray(G4int nx, G4int nz) {
+  fNBarsX = std::max(nx, 1);
+  fNBarsZ = std::max(nz, 1);
+  G4cout << "Bar array set to " << fNBarsX << " x " << fNBarsZ << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+G4int DetectorConstruction::GetDetectorID(const G4VTouchable* touch) const {
+  // plane copy number 1 (top) or 2 (bottom); in an array the cell and
+  // column replica numbers give the bar
+  G4int plane = touch->GetCopyNumber(0);
+  if (fNBarsX*fNBarsZ == 1 || touch->GetHistoryDepth() < 3) return plane;
+  G4int bar = touch->GetReplicaNumber(2)*fNBarsZ + touch->GetReplicaNumber(1);
+  return plane + 10*bar;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+G4bool DetectorConstruction::IsReadoutVolume(const G4LogicalVolume* lv) const {
+  // a handful of entries at most, a linear scan is the fastest lookup
+  for (const G4LogicalVolume* r : fReadoutLVs) {
+    if (r == lv) return true;
+  }
+  return false;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+G4OpticalSurface* DetectorConstruction::CreateSurface(const G4String& name) {
+  G4OpticalSurface* surface = FindSurface(name);
+  if (!surface) {
+    surface = new G4OpticalSurface(name);
+    surface->SetType(dielectric_dielectric);
+    surface->SetFinish(ground);
+    surface->SetModel(unified);
+    surface->SetMaterialPropertiesTable(new G4MaterialPropertiesTable());
+    fSurfaces[name] = surface;
+  }
+  SelectSurface(name);
+  return surface;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+G4bool DetectorConstruction::SelectSurface(const G4String& name) {
+  G4OpticalSurface* surface = FindSurface(name);
+  if (!surface) {
+    G4ExceptionDescription ed;
+    ed << "No optical surface named " << name
+       << "; create it with /opnovice2/surface/create.";
+    G4Exception("DetectorConstruction::SelectSurface", "OpNovice2_010",
+                JustWarning, ed);
+    return false;
+  }
+  fSurface    = surface;
+  fSurfaceMPT = surface->GetMaterialPropertiesTable();
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+G4OpticalSurface* DetectorConstruction::FindSurface(const G4String& name) const
+{
+  auto it = fSurfaces.find(name);
+  return it == fSurfaces.end() ? nullptr : it->second;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void DetectorConstruction::ListSurfaces() const {
+  for (auto it = fSurfaces.begin(); it != fSurfaces.end(); ++it) {
+    G4cout << (it->second == fSurface ? "* " : "  ") << it->first
+           << ": model " << EnumName(kModelNames, it->second->GetModel())
+           << ", type " << EnumName(kTypeNames, it->second->GetType())
+           << ", finish " << EnumName(kFinishNames, it->second->GetFinish())
+           << ", sigma alpha " << it->second->GetSigmaAlpha() << G4endl;
+  }
+  for (const SurfaceBinding& b : fSurfaceBindings) {
+    G4cout << "  " << b.surface
+           << (b.volume2.empty() ? " skin of " : " border ") << b.volume1
+           << (b.volume2.empty() ? "" : " -> ") << b.volume2 << G4endl;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void DetectorConstruction::AddBorderSurface(const G4String& surface,
+                                            const G4String& pv1,
+                                            const G4String& pv2) {
+  SurfaceBinding b = {surface, pv1, pv2};
+  fSurfaceBindings.push_back(b);
+  if (fWorld_PV) ApplySurfaceBinding(b);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void DetectorConstruction::AddSkinSurface(const G4String& surface,
+                                          const G4String& lv) {
+  SurfaceBinding b = {surface, lv, ""};
+  fSurfaceBindings.push_back(b);
+  if (fWorld_PV) ApplySurfaceBinding(b);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void DetectorConstruction::ApplySurfaceBinding(const SurfaceBinding& b) {
+  G4OpticalSurface* surface = FindSurface(b.surface);
+  G4ExceptionDescription ed;
+  if (!surface) {
+    ed << "No optical surface named " << b.surface << "; binding ignored.";
+  }
+  else if (b.volume2.empty()) {
+    G4LogicalVolume* lv =
+      G4LogicalVolumeStore::GetInstance()->GetVolume(b.volume1, false);
+    if (lv) {
+      new G4LogicalSkinSurface(b.surface + "_" + b.volume1, lv, surface);
+      return;
+    }
+    ed << "No logical volume named " << b.volume1 << " for skin surface "
+       << b.surface << ".";
+  }
+  else {
+    G4PhysicalVolumeStore* store = G4PhysicalVolumeStore::GetInstance();
+    G4VPhysicalVolume* pv1 = store->GetVolume(b.volume1, false);
+    G4VPhysicalVolume* pv2 = store->GetVolume(b.volume2, false);
+    if (pv1 && pv2 && !Touch(pv1, pv2)) {
+      // e.g. Tank -> World in a bar array, where the tank sits in BarCell:
+      // the photon leaves into the direct mother
+      G4VPhysicalVolume* from = pv1;
+      G4VPhysicalVolume* to   = pv2;
+      if (IsAncestor(pv2->GetLogicalVolume(), pv1)) {
+        to = FindPlacement(pv1->GetMotherLogical());
+      }
+      else if (IsAncestor(pv1->GetLogicalVolume(), pv2)) {
+        from = FindPlacement(pv2->GetMotherLogical());
+      }
+      if (from == pv1 && to == pv2) {
+        ed << "Physical volumes " << b.volume1 << " and " << b.volume2
+           << " do not touch; border surface " << b.surface
+           << " would never apply and is not attached.";
+        G4Exception("DetectorConstruction::ApplySurfaceBinding",
+                    "OpNovice2_010", JustWarning, ed);
+        return;
+      }
+      G4cout << "Border surface " << b.surface << " " << b.volume1
+             << " -> " << b.volume2 << " attached as " << from->GetName()
+             << " -> " << to->GetName() << G4endl;
+      pv1 = from;
+      pv2 = to;
+    }
+    if (pv1 && pv2) {
+      new G4LogicalBorderSurface(b.surface + "_" + pv1->GetName() + "_"
+                                 + pv2->GetName(), pv1, pv2, surface);
+      return;
+    }
+    ed << "No physical volume named "
+       << (pv1 ? b.volume2 : b.volume1) << " for border surface "
+       << b.surface << ".";
+  }
+  G4Exception("DetectorConstruction::ApplySurfaceBinding", "OpNovice2_010",
+              JustWarning, ed);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 void DetectorConstruction::SetSurfaceSigmaAlpha(G4double v) {
   fSurface->SetSigmaAlpha(v);
-  G4RunManager::GetRunManager()->GeometryHasBeenModified();
 
   G4cout << "Surface sigma alpha set to: " << fSurface->GetSigmaAlpha()
          << G4endl;
@@ -212,9 +749,6 @@ void DetectorConstruction::AddTankMPV(const char* c,
                                      G4MaterialPropertyVector* mpv) {
   mpv->SetSpline(true);
   fTankMPT->AddProperty(c, mpv);
-  G4cout << "The MPT for the box is now: " << G4endl;
-  fTankMPT->DumpTable();
-  G4cout << "............." << G4endl;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -222,9 +756,6 @@ void DetectorConstruction::AddWorldMPV(const char* c,
                                        G4MaterialPropertyVector* mpv) {
   mpv->SetSpline(true);
   fWorldMPT->AddProperty(c, mpv);
-  G4cout << "The MPT for the world is now: " << G4endl;
-  fWorldMPT->DumpTable();
-  G4cout << "............." << G4endl;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -232,25 +763,47 @@ void DetectorConstruction::AddSurfaceMPV(const char* c,
                                          G4MaterialPropertyVector* mpv) {
   mpv->SetSpline(true);
   fSurfaceMPT->AddProperty(c, mpv);
-  G4cout << "The MPT for the surface is now: " << G4endl;
-  fSurfaceMPT->DumpTable();
-  G4cout << "............." << G4endl;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 void DetectorConstruction::AddTankMPCV(const char* c, G4double v) {
   fTankMPT->AddConstProperty(c, v);
-  G4cout << "The MPT for the box is now: " << G4endl;
-  fTankMPT->DumpTable();
-  G4cout << "............." << G4endl;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 void DetectorConstruction::AddWorldMPCV(const char* c, G4double v) {
   fWorldMPT->AddConstProperty(c, v);
-  G4cout << "The MPT for the world is now: " << G4endl;
-  fWorldMPT->DumpTable();
-  G4cout << "............." << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void DetectorConstruction::AddSurfaceMPCV(const char* c, G4double v) {
+  fSurfaceMPT->AddConstProperty(c, v);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void DetectorConstruction::LoadProperties(const G4String& fileName) {
+  PropertyLoader loader(this);
+  loader.Load(fileName);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void DetectorConstruction::DumpProperties(const G4String& target) {
+  if (target == "box" || target == "all") {
+    G4cout << "The MPT for the box is now: " << G4endl;
+    fTankMPT->DumpTable();
+    G4cout << "............." << G4endl;
+  }
+  if (target == "world" || target == "all") {
+    G4cout << "The MPT for the world is now: " << G4endl;
+    fWorldMPT->DumpTable();
+    G4cout << "............." << G4endl;
+  }
+  if (target == "surface" || target == "all") {
+    G4cout << "The MPT for surface " << fSurface->GetName() << " is now: "
+           << G4endl;
+    fSurfaceMPT->DumpTable();
+    G4cout << "............." << G4endl;
+  }
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
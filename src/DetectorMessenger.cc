@@ -85,6 +85,56 @@ DetectorMessenger::DetectorMessenger(DetectorConstruction * Det)
   fSurfaceMatPropVectorCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
   fSurfaceMatPropVectorCmd->SetToBeBroadcasted(false);
 
+  fSurfaceDir = new G4UIdirectory("/opnovice2/surface/");
+  fSurfaceDir->SetGuidance("Named optical surfaces and their placement.");
+  fSurfaceDir->SetGuidance("The /opnovice2/surface* commands act on the ");
+  fSurfaceDir->SetGuidance("selected surface.");
+
+  fSurfaceCreateCmd =
+    new G4UIcmdWithAString("/opnovice2/surface/create", this);
+  fSurfaceCreateCmd->SetGuidance("Create a named optical surface with its ");
+  fSurfaceCreateCmd->SetGuidance("own properties table and select it.");
+  fSurfaceCreateCmd->SetParameterName("name", false);
+  fSurfaceCreateCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fSurfaceCreateCmd->SetToBeBroadcasted(false);
+
+  fSurfaceSelectCmd =
+    new G4UIcmdWithAString("/opnovice2/surface/select", this);
+  fSurfaceSelectCmd->SetGuidance("Select the surface the surface* ");
+  fSurfaceSelectCmd->SetGuidance("commands act on.");
+  fSurfaceSelectCmd->SetParameterName("name", false);
+  fSurfaceSelectCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fSurfaceSelectCmd->SetToBeBroadcasted(false);
+
+  fSurfaceBorderCmd = new G4UIcommand("/opnovice2/surface/border", this);
+  fSurfaceBorderCmd->SetGuidance("Attach a surface as border surface for ");
+  fSurfaceBorderCmd->SetGuidance("photons going from pv1 to pv2, e.g.");
+  fSurfaceBorderCmd->SetGuidance(" /opnovice2/surface/border Surface Tank World");
+  G4UIparameter* surfParam = new G4UIparameter("surface", 's', false);
+  fSurfaceBorderCmd->SetParameter(surfParam);
+  surfParam = new G4UIparameter("pv1", 's', false);
+  fSurfaceBorderCmd->SetParameter(surfParam);
+  surfParam = new G4UIparameter("pv2", 's', false);
+  fSurfaceBorderCmd->SetParameter(surfParam);
+  fSurfaceBorderCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fSurfaceBorderCmd->SetToBeBroadcasted(false);
+
+  fSurfaceSkinCmd = new G4UIcommand("/opnovice2/surface/skin", this);
+  fSurfaceSkinCmd->SetGuidance("Attach a surface as skin surface of a ");
+  fSurfaceSkinCmd->SetGuidance("logical volume.");
+  surfParam = new G4UIparameter("surface", 's', false);
+  fSurfaceSkinCmd->SetParameter(surfParam);
+  surfParam = new G4UIparameter("lv", 's', false);
+  fSurfaceSkinCmd->SetParameter(surfParam);
+  fSurfaceSkinCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fSurfaceSkinCmd->SetToBeBroadcasted(false);
+
+  fSurfaceListCmd =
+    new G4UIcmdWithoutParameter("/opnovice2/surface/list", this);
+  fSurfaceListCmd->SetGuidance("List the surfaces and where they are placed.");
+  fSurfaceListCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fSurfaceListCmd->SetToBeBroadcasted(false);
+
   fTankMatPropVectorCmd =
     new G4UIcmdWithAString("/opnovice2/boxProperty", this);
   fTankMatPropVectorCmd->SetGuidance("Set material property vector for ");
@@ -124,6 +174,85 @@ DetectorMessenger::DetectorMessenger(DetectorConstruction * Det)
   fWorldMaterialCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
   fWorldMaterialCmd->SetToBeBroadcasted(false);
 
+  fBarArrayCmd = new G4UIcommand("/opnovice2/barArray", this);
+  fBarArrayCmd->SetGuidance("Number of bars along x and along z;");
+  fBarArrayCmd->SetGuidance(" more than one bar builds a replicated array.");
+  G4UIparameter* param = new G4UIparameter("nx", 'i', false);
+  param->SetParameterRange("nx > 0");
+  fBarArrayCmd->SetParameter(param);
+  param = new G4UIparameter("nz", 'i', false);
+  param->SetParameterRange("nz > 0");
+  fBarArrayCmd->SetParameter(param);
+  fBarArrayCmd->AvailableForStates(G4State_PreInit);
+  fBarArrayCmd->SetToBeBroadcasted(false);
+
+  fBarGapCmd = new G4UIcmdWithADoubleAndUnit("/opnovice2/barGap", this);
+  fBarGapCmd->SetGuidance("Gap between neighbouring bars of the array.");
+  fBarGapCmd->SetParameterName("gap", false);
+  fBarGapCmd->SetRange("gap >= 0");
+  fBarGapCmd->SetUnitCategory("Length");
+  fBarGapCmd->SetDefaultUnit("mm");
+  fBarGapCmd->AvailableForStates(G4State_PreInit);
+  fBarGapCmd->SetToBeBroadcasted(false);
+
+  fLoadPropertiesCmd =
+    new G4UIcmdWithAString("/opnovice2/loadProperties", this);
+  fLoadPropertiesCmd->SetGuidance("Read material and surface property ");
+  fLoadPropertiesCmd->SetGuidance("tables and constants from a text or ");
+  fLoadPropertiesCmd->SetGuidance("binary file (see PropertyLoader.hh).");
+  fLoadPropertiesCmd->SetParameterName("fileName", false);
+  fLoadPropertiesCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fLoadPropertiesCmd->SetToBeBroadcasted(false);
+
+  fDumpPropertiesCmd =
+    new G4UIcmdWithAString("/opnovice2/dumpProperties", this);
+  fDumpPropertiesCmd->SetGuidance("Print the material properties tables.");
+  fDumpPropertiesCmd->SetParameterName("target", true);
+  fDumpPropertiesCmd->SetDefaultValue("all");
+  fDumpPropertiesCmd->SetCandidates("box world surface all");
+  fDumpPropertiesCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fDumpPropertiesCmd->SetToBeBroadcasted(false);
+
+  fRegionDir = new G4UIdirectory("/opnovice2/region/");
+  fRegionDir->SetGuidance("Production cuts and user limits of the regions");
+  fRegionDir->SetGuidance(" Tank, Detector and World.");
+
+  fRegionCutCmd = NewRegionCommand("/opnovice2/region/cut",
+    "Production cut for all particles in a region.", "Length", "mm");
+  fRegionMaxTrackLengthCmd =
+    NewRegionCommand("/opnovice2/region/maxTrackLength",
+    "Kill charged tracks longer than this in a region.", "Length", "m");
+  fRegionMaxTrackLengthCmd->SetGuidance(
+    " Photons and other neutrals too after /opnovice2/physics/limitNeutrals.");
+  fRegionMaxTimeCmd = NewRegionCommand("/opnovice2/region/maxTime",
+    "Kill charged tracks beyond this global time in a region.", "Time", "ns");
+  fRegionMaxTimeCmd->SetGuidance(
+    " Photons and other neutrals too after /opnovice2/physics/limitNeutrals.");
+  fRegionMinEkinCmd = NewRegionCommand("/opnovice2/region/minEkin",
+    "Kill charged tracks below this kinetic energy in a region.",
+    "Energy", "keV");
+
+  fRegionPrintCmd =
+    new G4UIcmdWithoutParameter("/opnovice2/region/print", this);
+  fRegionPrintCmd->SetGuidance("Print the cuts and limits of the regions.");
+  fRegionPrintCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fRegionPrintCmd->SetToBeBroadcasted(false);
+
+  fGdmlDir = new G4UIdirectory("/opnovice2/gdml/");
+  fGdmlDir->SetGuidance("GDML geometry import and export");
+
+  fGdmlReadCmd = new G4UIcmdWithAString("/opnovice2/gdml/read", this);
+  fGdmlReadCmd->SetGuidance("Build the geometry from a GDML file instead ");
+  fGdmlReadCmd->SetGuidance("of the built-in bar(s).");
+  fGdmlReadCmd->SetParameterName("fileName", false);
+  fGdmlReadCmd->AvailableForStates(G4State_PreInit);
+  fGdmlReadCmd->SetToBeBroadcasted(false);
+
+  fGdmlWriteCmd = new G4UIcmdWithAString("/opnovice2/gdml/write", this);
+  fGdmlWriteCmd->SetGuidance("Write the current geometry to a GDML file.");
+  fGdmlWriteCmd->SetParameterName("fileName", false);
+  fGdmlWriteCmd->AvailableForStates(G4State_Idle);
+  fGdmlWriteCmd->SetToBeBroadcasted(false);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -135,12 +264,56 @@ DetectorMessenger::~DetectorMessenger()
   delete fSurfaceModelCmd;
   delete fSurfaceSigmaAlphaCmd;
   delete fSurfaceMatPropVectorCmd;
+  delete fSurfaceCreateCmd;
+  delete fSurfaceSelectCmd;
+  delete fSurfaceBorderCmd;
+  delete fSurfaceSkinCmd;
+  delete fSurfaceListCmd;
+  delete fSurfaceDir;
   delete fTankMatPropVectorCmd;
   delete fTankMatConstPropVectorCmd;
   delete fTankMaterialCmd;
   delete fWorldMatPropVectorCmd;
   delete fWorldMatConstPropVectorCmd;
   delete fWorldMaterialCmd;
+  delete fBarArrayCmd;
+  delete fBarGapCmd;
+  delete fLoadPropertiesCmd;
+  delete fDumpPropertiesCmd;
+  delete fRegionCutCmd;
+  delete fRegionMaxTrackLengthCmd;
+  delete fRegionMaxTimeCmd;
+  delete fRegionMinEkinCmd;
+  delete fRegionPrintCmd;
+  delete fRegionDir;
+  delete fGdmlReadCmd;
+  delete fGdmlWriteCmd;
+  delete fGdmlDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4UIcommand* DetectorMessenger::NewRegionCommand(const char* path,
+                                                 const char* guidance,
+                                                 const char* unitCategory,
+                                                 const char* defaultUnit)
+{
+  G4UIcommand* cmd = new G4UIcommand(path, this);
+  cmd->SetGuidance(guidance);
+  G4UIparameter* param = new G4UIparameter("region", 's', false);
+  param->SetParameterCandidates("Tank Detector World");
+  cmd->SetParameter(param);
+  param = new G4UIparameter("value", 'd', false);
+  param->SetParameterRange("value >= 0");
+  cmd->SetParameter(param);
+  param = new G4UIparameter("unit", 's', true);
+  param->SetDefaultValue(defaultUnit);
+  param->SetParameterCandidates(
+    G4UIcommand::UnitsList(unitCategory).c_str());
+  cmd->SetParameter(param);
+  cmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  cmd->SetToBeBroadcasted(false);
+  return cmd;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -422,6 +595,73 @@ void DetectorMessenger::SetNewValue(G4UIcommand* command,G4String newValue)
   else if (command == fTankMaterialCmd) {
     fDetector->SetTankMaterial(newValue);
   }
+  else if (command == fBarArrayCmd) {
+    std::istringstream instring(newValue);
+    G4int nx, nz;
+    instring >> nx >> nz;
+    fDetector->SetBarArray(nx, nz);
+  }
+  else if (command == fBarGapCmd) {
+    fDetector->SetBarGap(fBarGapCmd->GetNewDoubleValue(newValue));
+  }
+  else if (command == fLoadPropertiesCmd) {
+    fDetector->LoadProperties(newValue);
+  }
+  else if (command == fDumpPropertiesCmd) {
+    fDetector->DumpProperties(newValue);
+  }
+  else if (command == fSurfaceCreateCmd) {
+    fDetector->CreateSurface(newValue);
+  }
+  else if (command == fSurfaceSelectCmd) {
+    fDetector->SelectSurface(newValue);
+  }
+  else if (command == fSurfaceBorderCmd) {
+    G4String surface, pv1, pv2;
+    std::istringstream instring(newValue);
+    instring >> surface >> pv1 >> pv2;
+    fDetector->AddBorderSurface(surface, pv1, pv2);
+  }
+  else if (command == fSurfaceSkinCmd) {
+    G4String surface, lv;
+    std::istringstream instring(newValue);
+    instring >> surface >> lv;
+    fDetector->AddSkinSurface(surface, lv);
+  }
+  else if (command == fSurfaceListCmd) {
+    fDetector->ListSurfaces();
+  }
+  else if (command == fRegionCutCmd ||
+           command == fRegionMaxTrackLengthCmd ||
+           command == fRegionMaxTimeCmd ||
+           command == fRegionMinEkinCmd) {
+    G4String region, unit;
+    G4double value;
+    std::istringstream instring(newValue);
+    instring >> region >> value >> unit;
+    value *= G4UIcommand::ValueOf(unit);
+    if (command == fRegionCutCmd) {
+      fDetector->SetRegionCut(region, value);
+    }
+    else if (command == fRegionMaxTrackLengthCmd) {
+      fDetector->SetRegionMaxTrackLength(region, value);
+    }
+    else if (command == fRegionMaxTimeCmd) {
+      fDetector->SetRegionMaxTime(region, value);
+    }
+    else {
+      fDetector->SetRegionMinEkin(region, value);
+    }
+  }
+  else if (command == fRegionPrintCmd) {
+    fDetector->PrintRegions();
+  }
+  else if (command == fGdmlReadCmd) {
+    fDetector->SetGDMLFile(newValue);
+  }
+  else if (command == fGdmlWriteCmd) {
+    fDetector->WriteGDML(newValue);
+  }
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,278 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/src/DetectorTally.cc
+/// \brief Implementation of the DetectorTally class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "DetectorTally.hh"
+#include "RunSummary.hh"
+
+#include "G4SystemOfUnits.hh"
+#include "G4PhysicalConstants.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
+namespace {
+  G4int    timeBins       = 1000;
+  G4double timeMin        = 0.;
+  G4double timeMax        = 100.*ns;
+  G4int    wavelengthBins = 600;
+  G4double wavelengthMin  = 200.*nm;
+  G4double wavelengthMax  = 800.*nm;
+  G4String outputFile;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorTally::Spectrum::Set(G4int n, G4double lo, G4double hi)
+{
+  bins  = n;
+  min   = lo;
+  max   = hi;
+  scale = n/(hi - lo);
+  counts.assign(n + 2, 0);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double DetectorTally::Spectrum::Quantile(G4double p) const
+{
+  G4long total = 0;
+  for (size_t i = 0; i < counts.size(); ++i) total += counts[i];
+  if (total == 0) return 0.;
+  G4double target = p*total;
+  G4double sum = 0.;
+  for (G4int i = 0; i < bins + 2; ++i) {
+    if (sum + counts[i] >= target && counts[i] > 0) {
+      if (i == 0) return min;
+      if (i == bins + 1) return max;
+      // linear within the bin
+      G4double low = min + (i - 1)/scale;
+      return low + (target - sum)/counts[i]/scale;
+    }
+    sum += counts[i];
+  }
+  return max;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+DetectorTally::DetectorTally()
+{
+  fTime.Set(timeBins, timeMin, timeMax);
+  fWavelength.Set(wavelengthBins, wavelengthMin, wavelengthMax);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+DetectorTally::~DetectorTally()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorTally::SetTimeBinning(G4int bins, G4double min, G4double max)
+{
+  timeBins = bins;
+  timeMin  = min;
+  timeMax  = max;
+}
+
+void DetectorTally::SetWavelengthBinning(G4int bins, G4double min,
+                                         G4double max)
+{
+  wavelengthBins = bins;
+  wavelengthMin  = min;
+  wavelengthMax  = max;
+}
+
+void DetectorTally::SetOutputFile(const G4String& name) {outputFile = name;}
+
+const G4String& DetectorTally::GetOutputFile() {return outputFile;}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorTally::AddHit(G4int detector, G4double time, G4double energy)
+{
+  if (detector < 0) return;
+  if (detector >= G4int(fDetectors.size())) {
+    Detector empty = {0, 0., 0., std::numeric_limits<G4double>::max(), 0.};
+    fDetectors.resize(detector + 1, empty);
+  }
+  G4double wavelength = energy > 0. ? h_Planck*c_light/energy : 0.;
+  Detector& d = fDetectors[detector];
+  ++d.hits;
+  d.sumTime += time;
+  d.sumTime2 += time*time;
+  d.minTime = std::min(d.minTime, time);
+  d.sumWavelength += wavelength;
+
+  fTime.Fill(time);
+  fWavelength.Fill(wavelength);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorTally::Merge(const DetectorTally& other)
+{
+  if (other.fDetectors.size() > fDetectors.size()) {
+    Detector empty = {0, 0., 0., std::numeric_limits<G4double>::max(), 0.};
+    fDetectors.resize(other.fDetectors.size(), empty);
+  }
+  for (size_t i = 0; i < other.fDetectors.size(); ++i) {
+    const Detector& o = other.fDetectors[i];
+    Detector& d = fDetectors[i];
+    d.hits += o.hits;
+    d.sumTime += o.sumTime;
+    d.sumTime2 += o.sumTime2;
+    d.minTime = std::min(d.minTime, o.minTime);
+    d.sumWavelength += o.sumWavelength;
+  }
+  // the binning is only changed between runs, so all runs share it
+  size_t n = std::min(fTime.counts.size(), other.fTime.counts.size());
+  for (size_t i = 0; i < n; ++i) fTime.counts[i] += other.fTime.counts[i];
+  n = std::min(fWavelength.counts.size(), other.fWavelength.counts.size());
+  for (size_t i = 0; i < n; ++i) {
+    fWavelength.counts[i] += other.fWavelength.counts[i];
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4long DetectorTally::GetHits() const
+{
+  G4long hits = 0;
+  for (size_t i = 0; i < fDetectors.size(); ++i) hits += fDetectors[i].hits;
+  return hits;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorTally::Print(G4int events, G4long trackedPhotons) const
+{
+  G4long hits = GetHits();
+  if (hits == 0) return;
+
+  std::ios::fmtflags mode = G4cout.flags();
+  G4int prec = G4cout.precision(4);
+
+  G4cout << "\n Optical photons at the readout planes: " << hits
+         << " (" << G4double(hits)/std::max(events, 1) << " per event";
+  if (trackedPhotons > 0) {
+    G4cout << ", " << 100.*hits/trackedPhotons << " % of tracked photons";
+  }
+  G4cout << ")" << G4endl;
+  G4cout << "  " << std::setw(9) << "detector" << std::setw(12) << "photons"
+         << std::setw(12) << "per event" << std::setw(12) << "first ns"
+         << std::setw(12) << "mean ns" << std::setw(12) << "rms ns"
+         << std::setw(12) << "mean nm" << G4endl;
+  for (size_t i = 0; i < fDetectors.size(); ++i) {
+    const Detector& d = fDetectors[i];
+    if (d.hits == 0) continue;
+    G4double mean = d.sumTime/d.hits;
+    G4double rms = std::sqrt(std::max(d.sumTime2/d.hits - mean*mean, 0.));
+    G4cout << "  " << std::setw(9) << i << std::setw(12) << d.hits
+           << std::setw(12) << G4double(d.hits)/std::max(events, 1)
+           << std::setw(12) << d.minTime/ns << std::setw(12) << mean/ns
+           << std::setw(12) << rms/ns
+           << std::setw(12) << d.sumWavelength/d.hits/nm << G4endl;
+  }
+  G4cout << "  arrival time 10/50/90 %: " << fTime.Quantile(0.1)/ns << " / "
+         << fTime.Quantile(0.5)/ns << " / " << fTime.Quantile(0.9)/ns
+         << " ns (" << fTime.counts[0] + fTime.counts[fTime.bins + 1]
+         << " outside " << fTime.min/ns << "-" << fTime.max/ns << " ns)"
+         << G4endl;
+  G4cout << "  wavelength 10/50/90 %:   " << fWavelength.Quantile(0.1)/nm
+         << " / " << fWavelength.Quantile(0.5)/nm << " / "
+         << fWavelength.Quantile(0.9)/nm << " nm" << G4endl;
+
+  G4cout.flags(mode);
+  G4cout.precision(prec);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorTally::Write(const G4String& fileName) const
+{
+  std::ofstream out(fileName);
+  if (!out) {
+    G4ExceptionDescription ed;
+    ed << "Cannot write the detector spectra to " << fileName;
+    G4Exception("DetectorTally::Write", "OpNovice2_024", JustWarning, ed);
+    return;
+  }
+  // under- and overflow are the first and last rows of each spectrum
+  out << "spectrum,low,high,photons\n";
+  const Spectrum* spectra[2] = {&fTime, &fWavelength};
+  const char* names[2] = {"time_ns", "wavelength_nm"};
+  const G4double units[2] = {ns, nm};
+  for (G4int s = 0; s < 2; ++s) {
+    const Spectrum& sp = *spectra[s];
+    for (G4int i = 0; i < sp.bins + 2; ++i) {
+      out << names[s] << ",";
+      if (i == 0) out << "-inf";
+      else out << (sp.min + (i - 1)/sp.scale)/units[s];
+      out << ",";
+      if (i == sp.bins + 1) out << "inf";
+      else out << (sp.min + i/sp.scale)/units[s];
+      out << "," << sp.counts[i] << "\n";
+    }
+  }
+  G4cout << "Detector spectra written to " << fileName << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorTally::FillSummary(RunSummary& summary, G4int events) const
+{
+  G4long hits = GetHits();
+  summary.Add("detectors", "photons", hits);
+  summary.Add("detectors", "photons_per_event",
+              events > 0 ? G4double(hits)/events : 0.);
+  summary.Add("detectors", "time_p10_ns", fTime.Quantile(0.1)/ns);
+  summary.Add("detectors", "time_p50_ns", fTime.Quantile(0.5)/ns);
+  summary.Add("detectors", "time_p90_ns", fTime.Quantile(0.9)/ns);
+  summary.Add("detectors", "wavelength_p50_nm", fWavelength.Quantile(0.5)/nm);
+  // one group of keys per detector that saw light
+  for (size_t i = 0; i < fDetectors.size(); ++i) {
+    const Detector& d = fDetectors[i];
+    if (d.hits == 0) continue;
+    std::ostringstream key;
+    key << "detector" << i << "_";
+    summary.Add("detectors", key.str() + "photons", d.hits);
+    summary.Add("detectors", key.str() + "first_ns", d.minTime/ns);
+    summary.Add("detectors", key.str() + "mean_ns", d.sumTime/d.hits/ns);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,332 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/src/Efficiencies.cc
+/// \brief Implementation of the Efficiencies class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "Efficiencies.hh"
+#include "RunSummary.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+
+namespace {
+  G4int    batchSize   = 100;
+  G4double targetError = 0.;
+  G4int    targetMask  = 0;
+
+  // before these the estimates are too rough to stop on
+  const G4long kMinEvents  = 100;
+  const G4long kMinPass    = 10;
+  const G4long kMinBatches = 10;
+
+  // shared by the threads for /opnovice2/run/beamUntil
+  std::atomic<G4long> sharedPass[Efficiencies::kNQuantities];
+  std::atomic<G4long> sharedTotal[Efficiencies::kNQuantities];
+  std::atomic<G4long> sharedBatches[Efficiencies::kNQuantities];
+  std::atomic<double> sharedBatchSum[Efficiencies::kNQuantities];
+  std::atomic<double> sharedBatchSum2[Efficiencies::kNQuantities];
+  std::atomic<G4long> sharedEvents(0);
+  std::atomic<bool>   reached(false);
+
+  const char* names[Efficiencies::kNQuantities] = {
+    "detection", "fresnelRefraction", "fresnelReflection", "absorptionPrior"
+  };
+
+  const char* descriptions[Efficiencies::kNQuantities] = {
+    "tracked photons reaching a readout plane",
+    "surface events with Fresnel refraction",
+    "surface events with Fresnel reflection",
+    "photons absorbed before the surface"
+  };
+
+  //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+  void AddAtomic(std::atomic<double>& target, double value)
+  {
+    double old = target.load(std::memory_order_relaxed);
+    while (!target.compare_exchange_weak(old, old + value,
+                                         std::memory_order_relaxed)) {}
+  }
+
+  void Wilson(G4long pass, G4long total, G4double z,
+              G4double& low, G4double& high)
+  {
+    if (total <= 0) {
+      low = 0.;
+      high = 1.;
+      return;
+    }
+    if (pass > total) {
+      G4ExceptionDescription ed;
+      ed << "Pass count " << pass << " is above the total " << total
+         << ", the interval is not valid.";
+      G4Exception("Efficiencies::Wilson", "OpNovice2_028", JustWarning, ed);
+    }
+    G4double n = total;
+    G4double p = pass/n;
+    G4double z2 = z*z;
+    G4double denominator = 1. + z2/n;
+    G4double centre = (p + z2/(2.*n))/denominator;
+    G4double half = z*std::sqrt(p*(1. - p)/n + z2/(4.*n*n))/denominator;
+    low = std::max(centre - half, 0.);
+    high = std::min(centre + half, 1.);
+  }
+
+  G4double BatchError(G4long batches, G4double sum, G4double sum2)
+  {
+    if (batches < kMinBatches) return -1.;
+    G4double mean = sum/batches;
+    G4double variance = (sum2 - batches*mean*mean)/(batches - 1);
+    return std::sqrt(std::max(variance, 0.)/batches);
+  }
+
+  // one standard deviation, the larger of the two estimates
+  G4double Error(G4long pass, G4long total, G4double batchError)
+  {
+    G4double low, high;
+    Wilson(pass, total, 1., low, high);
+    return std::max(0.5*(high - low), batchError);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+Efficiencies::Efficiencies()
+  : fBatchEvents(0)
+{
+  for (G4int q = 0; q < kNQuantities; ++q) {
+    fPass[q] = fTotal[q] = 0;
+    fBatches[q] = 0;
+    fBatchSum[q] = fBatchSum2[q] = 0.;
+    fBatchPass[q] = fBatchTotal[q] = 0;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+Efficiencies::~Efficiencies()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const char* Efficiencies::GetName(Quantity q) {return names[q];}
+
+G4bool Efficiencies::FindQuantity(const G4String& name, Quantity& q)
+{
+  for (G4int i = 0; i < kNQuantities; ++i) {
+    if (name == names[i]) {
+      q = Quantity(i);
+      return true;
+    }
+  }
+  return false;
+}
+
+void Efficiencies::SetBatchSize(G4int events) {batchSize = events;}
+
+void Efficiencies::SetTarget(G4double relativeError, G4int mask)
+{
+  targetError = relativeError;
+  targetMask = mask;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Efficiencies::ResetTarget()
+{
+  for (G4int q = 0; q < kNQuantities; ++q) {
+    sharedPass[q] = 0;
+    sharedTotal[q] = 0;
+    sharedBatches[q] = 0;
+    sharedBatchSum[q] = 0.;
+    sharedBatchSum2[q] = 0.;
+  }
+  sharedEvents = 0;
+  reached = false;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool Efficiencies::EndEvent(const G4long pass[], const G4long total[])
+{
+  G4bool adaptive = targetError > 0.;
+  for (G4int q = 0; q < kNQuantities; ++q) {
+    if (adaptive && (pass[q] != fPass[q] || total[q] != fTotal[q])) {
+      sharedPass[q].fetch_add(pass[q] - fPass[q], std::memory_order_relaxed);
+      sharedTotal[q].fetch_add(total[q] - fTotal[q],
+                               std::memory_order_relaxed);
+    }
+    fPass[q] = pass[q];
+    fTotal[q] = total[q];
+  }
+
+  if (++fBatchEvents >= batchSize) {
+    for (G4int q = 0; q < kNQuantities; ++q) {
+      G4long n = fTotal[q] - fBatchTotal[q];
+      if (n > 0) {
+        G4double f = G4double(fPass[q] - fBatchPass[q])/n;
+        fBatchSum[q] += f;
+        fBatchSum2[q] += f*f;
+        ++fBatches[q];
+        if (adaptive) {
+          AddAtomic(sharedBatchSum[q], f);
+          AddAtomic(sharedBatchSum2[q], f*f);
+          sharedBatches[q].fetch_add(1, std::memory_order_relaxed);
+        }
+      }
+      fBatchPass[q] = fPass[q];
+      fBatchTotal[q] = fTotal[q];
+    }
+    fBatchEvents = 0;
+  }
+
+  if (!adaptive) return false;
+  G4long events = sharedEvents.fetch_add(1, std::memory_order_relaxed) + 1;
+  if (reached.load(std::memory_order_relaxed)) return true;
+  if (events < kMinEvents) return false;
+  for (G4int q = 0; q < kNQuantities; ++q) {
+    if (!(targetMask & (1 << q))) continue;
+    G4long p = sharedPass[q].load(std::memory_order_relaxed);
+    G4long n = sharedTotal[q].load(std::memory_order_relaxed);
+    if (p < kMinPass) return false;
+    G4double batch = BatchError(
+      sharedBatches[q].load(std::memory_order_relaxed),
+      sharedBatchSum[q].load(std::memory_order_relaxed),
+      sharedBatchSum2[q].load(std::memory_order_relaxed));
+    // the Wilson error alone is too small for correlated photons
+    if (batch < 0.) return false;
+    if (Error(p, n, batch) > targetError*p/n) return false;
+  }
+  reached = true;
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Efficiencies::Merge(const Efficiencies& other)
+{
+  for (G4int q = 0; q < kNQuantities; ++q) {
+    fPass[q] += other.fPass[q];
+    fTotal[q] += other.fTotal[q];
+    fBatches[q] += other.fBatches[q];
+    fBatchSum[q] += other.fBatchSum[q];
+    fBatchSum2[q] += other.fBatchSum2[q];
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double Efficiencies::GetValue(Quantity q) const
+{
+  return fTotal[q] > 0 ? G4double(fPass[q])/fTotal[q] : 0.;
+}
+
+G4double Efficiencies::GetBatchError(Quantity q) const
+{
+  return BatchError(fBatches[q], fBatchSum[q], fBatchSum2[q]);
+}
+
+G4double Efficiencies::GetError(Quantity q) const
+{
+  return Error(fPass[q], fTotal[q], GetBatchError(q));
+}
+
+void Efficiencies::GetWilson(Quantity q, G4double z, G4double& low,
+                             G4double& high) const
+{
+  Wilson(fPass[q], fTotal[q], z, low, high);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Efficiencies::Print() const
+{
+  std::ios::fmtflags mode = G4cout.flags();
+  G4int prec = G4cout.precision(4);
+
+  G4cout << "\n Efficiencies (error: larger of Wilson and batch means over "
+         << batchSize << " events):" << G4endl;
+  for (G4int i = 0; i < kNQuantities; ++i) {
+    Quantity q = Quantity(i);
+    if (fTotal[q] == 0) continue;
+    G4double value = GetValue(q);
+    G4double error = GetError(q);
+    G4double low, high;
+    GetWilson(q, 1.96, low, high);
+    G4cout << "  " << std::setw(18) << std::left << names[q] << std::right
+           << std::setw(10) << fPass[q] << " /" << std::setw(11) << fTotal[q]
+           << " = " << std::setw(10) << value << " +- " << std::setw(10)
+           << error;
+    if (value > 0.) G4cout << " (" << 100.*error/value << " %)";
+    G4cout << "  95 %: [" << low << ", " << high << "]";
+    G4double batch = GetBatchError(q);
+    if (batch >= 0.) {
+      G4cout << "  batches: " << batch << " (" << fBatches[q] << ")";
+    }
+    G4cout << "  " << descriptions[q] << G4endl;
+  }
+  if (targetError > 0.) {
+    G4cout << "  target relative error " << targetError << " on";
+    for (G4int q = 0; q < kNQuantities; ++q) {
+      if (targetMask & (1 << q)) G4cout << " " << names[q];
+    }
+    G4cout << (reached ? ": reached after " : ": not reached in ")
+           << sharedEvents.load() << " events" << G4endl;
+  }
+
+  G4cout.flags(mode);
+  G4cout.precision(prec);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Efficiencies::FillSummary(RunSummary& summary) const
+{
+  for (G4int i = 0; i < kNQuantities; ++i) {
+    Quantity q = Quantity(i);
+    G4String name = names[q];
+    G4double low, high;
+    GetWilson(q, 1.96, low, high);
+    summary.Add("efficiencies", name + "_pass", fPass[q]);
+    summary.Add("efficiencies", name + "_total", fTotal[q]);
+    summary.Add("efficiencies", name, GetValue(q));
+    summary.Add("efficiencies", name + "_error", GetError(q));
+    summary.Add("efficiencies", name + "_wilson95_low", low);
+    summary.Add("efficiencies", name + "_wilson95_high", high);
+  }
+  summary.Add("efficiencies", "target_relative_error", targetError);
+  summary.Add("efficiencies", "target_reached",
+              targetError > 0. && reached.load());
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
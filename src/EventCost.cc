@@ -0,0 +1,253 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/src/EventCost.cc
+/// \brief Implementation of the EventCost class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "EventCost.hh"
+#include "EventSeeder.hh"
+#include "RunSummary.hh"
+
+#include "G4Event.hh"
+#include "G4RunManager.hh"
+#include "G4Run.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+namespace {
+  const G4int    kBinsPerDecade = 10;
+  const G4double kMinLog        = -7.;   // 100 ns
+  const G4int    kNBins         = 10*kBinsPerDecade;
+  // events a thread must have seen before its percentile is trusted
+  const G4long   kMinEvents     = 100;
+
+  // percentiles of the printout and the run summary
+  const G4int    kNPercentiles = 4;
+  const G4double kPercentiles[kNPercentiles] = {50., 90., 99., 99.9};
+  const char*    kPercentileKeys[kNPercentiles] =
+    {"p50_s", "p90_s", "p99_s", "p999_s"};
+
+  G4double slowPercentile = 0.;
+  G4int    nWorst         = 5;
+
+  inline G4double Now()
+  {
+    return std::chrono::duration<G4double>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+
+  // 0 is underflow, kNBins+1 overflow
+  inline G4int Bin(G4double t)
+  {
+    if (t <= 0.) return 0;
+    G4int bin = (G4int)std::floor((std::log10(t) - kMinLog)*kBinsPerDecade);
+    return std::min(std::max(bin + 1, 0), kNBins + 1);
+  }
+
+  inline G4double BinEdge(G4int i)   // lower edge of bin i >= 1
+  {
+    return std::pow(10., kMinLog + G4double(i - 1)/kBinsPerDecade);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EventCost::EventCost()
+  : fBins(kNBins + 2, 0),
+    fEvents(0), fSumTime(0.), fSumSteps(0), fSumPhotons(0),
+    fStart(0.), fStartSteps(0), fStartPhotons(0)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EventCost::~EventCost()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EventCost::SetSlowPercentile(G4double p) {slowPercentile = p;}
+void EventCost::SetNumberOfWorst(G4int n) {nWorst = n;}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EventCost::BeginEvent(G4long steps, G4long photons)
+{
+  fStartSteps   = steps;
+  fStartPhotons = photons;
+  fStart        = Now();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EventCost::EndEvent(const G4Event* event, G4long steps, G4long photons)
+{
+  Event ev;
+  ev.time    = Now() - fStart;
+  ev.id      = EventSeeder::GetGlobalEventID(event);
+  ev.seeded  = EventSeeder::GetEventSeeds(event, ev.seeds);
+  ev.steps   = steps - fStartSteps;
+  ev.photons = photons - fStartPhotons;
+
+  // compare with the events before this one
+  if (slowPercentile > 0. && fEvents >= kMinEvents &&
+      ev.time > Percentile(slowPercentile)) {
+    G4RunManager* runManager = G4RunManager::GetRunManager();
+    G4cout << "Slow event " << ev.id << ": " << ev.time << " s, "
+           << ev.steps << " steps, " << ev.photons << " photons (above "
+           << slowPercentile << "th percentile)";
+    if (ev.seeded) G4cout << ", seeds " << ev.seeds[0] << " " << ev.seeds[1];
+    if (runManager->GetRandomNumberStore()) {
+      runManager->rndmSaveThisEvent();
+      G4cout << ", engine status saved to run"
+             << runManager->GetCurrentRun()->GetRunID() << "evt"
+             << event->GetEventID() << ".rndm";
+    }
+    G4cout << G4endl;
+  }
+
+  ++fBins[Bin(ev.time)];
+  ++fEvents;
+  fSumTime    += ev.time;
+  fSumSteps   += ev.steps;
+  fSumPhotons += ev.photons;
+  KeepWorst(ev);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EventCost::KeepWorst(const Event& ev)
+{
+  if (nWorst <= 0) return;
+  if ((G4int)fWorst.size() == nWorst && ev.time <= fWorst.back().time) return;
+  auto it = std::upper_bound(fWorst.begin(), fWorst.end(), ev,
+    [](const Event& a, const Event& b) {return a.time > b.time;});
+  fWorst.insert(it, ev);
+  if ((G4int)fWorst.size() > nWorst) fWorst.pop_back();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double EventCost::Percentile(G4double p) const
+{
+  if (fEvents == 0) return 0.;
+  const G4double target = p/100.*fEvents;
+  G4double count = fBins[0];
+  if (count >= target) return BinEdge(1);
+  for (G4int i = 1; i <= kNBins; ++i) {
+    if (count + fBins[i] >= target) {
+      // geometric interpolation within the bin
+      const G4double f = (target - count)/fBins[i];
+      return BinEdge(i)*std::pow(10., f/kBinsPerDecade);
+    }
+    count += fBins[i];
+  }
+  return BinEdge(kNBins + 1);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EventCost::Merge(const EventCost& other)
+{
+  for (size_t i = 0; i < fBins.size(); ++i) fBins[i] += other.fBins[i];
+  fEvents     += other.fEvents;
+  fSumTime    += other.fSumTime;
+  fSumSteps   += other.fSumSteps;
+  fSumPhotons += other.fSumPhotons;
+  for (const Event& ev : other.fWorst) KeepWorst(ev);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EventCost::Print() const
+{
+  if (fEvents == 0) return;
+
+  std::ios::fmtflags mode = G4cout.flags();
+  G4int prec = G4cout.precision(3);
+  G4cout << "\n Event cost (" << fEvents << " events): mean "
+         << fSumTime/fEvents << " s, " << G4double(fSumSteps)/fEvents
+         << " steps, " << G4double(fSumPhotons)/fEvents << " photons\n"
+         << "  time percentiles";
+  for (G4int i = 0; i < kNPercentiles; ++i) {
+    G4cout << "  " << kPercentiles[i] << "%: " << Percentile(kPercentiles[i])
+           << " s";
+  }
+  G4cout << G4endl;
+  if (!fWorst.empty()) {
+    G4cout << "  most expensive events:" << G4endl;
+    for (const Event& ev : fWorst) {
+      G4cout << "   event " << std::setw(8) << ev.id << std::setw(10)
+             << ev.time << " s " << std::setw(12) << ev.steps << " steps "
+             << std::setw(10) << ev.photons << " photons";
+      if (ev.seeded) {
+        G4cout << "  seeds " << ev.seeds[0] << " " << ev.seeds[1];
+      }
+      G4cout << G4endl;
+    }
+  }
+  G4cout.flags(mode);
+  G4cout.precision(prec);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EventCost::FillSummary(RunSummary& summary) const
+{
+  for (G4int i = 0; i < kNPercentiles; ++i) {
+    if (fEvents > 0) {
+      summary.Add("event_time", kPercentileKeys[i],
+                  Percentile(kPercentiles[i]));
+    }
+    else summary.AddNull("event_time", kPercentileKeys[i]);
+  }
+  // most expensive first, by global event number
+  for (size_t i = 0; i < fWorst.size(); ++i) {
+    const Event& ev = fWorst[i];
+    std::ostringstream key;
+    key << "worst" << i << "_";
+    summary.Add("event_time", key.str() + "event", ev.id);
+    summary.Add("event_time", key.str() + "s", ev.time);
+    summary.Add("event_time", key.str() + "steps", ev.steps);
+    summary.Add("event_time", key.str() + "photons", ev.photons);
+    if (ev.seeded) {
+      summary.Add("event_time", key.str() + "seed0", G4long(ev.seeds[0]));
+      summary.Add("event_time", key.str() + "seed1", G4long(ev.seeds[1]));
+    }
+    else {
+      summary.AddNull("event_time", key.str() + "seed0");
+      summary.AddNull("event_time", key.str() + "seed1");
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,94 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/src/EventSeeder.cc
+/// \brief Implementation of the EventSeeder class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "EventSeeder.hh"
+
+#include "G4Event.hh"
+#include "Randomize.hh"
+
+#include <cstdint>
+
+namespace {
+  G4long seed   = 0;
+  G4long offset = 0;
+
+  inline uint64_t SplitMix64(uint64_t x)
+  {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30))*0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27))*0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+  }
+
+  // engines want positive, non-zero seeds
+  inline long ToSeed(uint64_t x)
+  {
+    long s = static_cast<long>(x & 0x7fffffff);
+    return s ? s : 1;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void   EventSeeder::SetSeed(G4long value) {seed = value;}
+G4long EventSeeder::GetSeed() {return seed;}
+void   EventSeeder::SetOffset(G4long value) {offset = value;}
+G4long EventSeeder::GetOffset() {return offset;}
+
+G4long EventSeeder::GetGlobalEventID(const G4Event* event)
+{
+  return offset + event->GetEventID();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool EventSeeder::GetEventSeeds(const G4Event* event, long seeds[2])
+{
+  if (seed == 0) return false;
+  uint64_t state = SplitMix64(static_cast<uint64_t>(seed)) ^
+                   static_cast<uint64_t>(GetGlobalEventID(event));
+  uint64_t first = SplitMix64(state);
+  uint64_t second = SplitMix64(first);
+  seeds[0] = ToSeed(first);
+  seeds[1] = ToSeed(second);
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EventSeeder::Seed(const G4Event* event)
+{
+  long seeds[3] = { 0, 0, 0 };
+  if (GetEventSeeds(event, seeds)) G4Random::setTheSeeds(seeds);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -74,8 +74,22 @@ void HistoManager::Book()
   analysisManager->CreateNtupleDColumn("ke");//10
   analysisManager->CreateNtupleIColumn("evNr");//11
   analysisManager->CreateNtupleDColumn("time");//12
-  analysisManager->CreateNtupleIColumn("detID");//13
+  analysisManager->CreateNtupleIColumn("detID");//13 plane + 10*bar
   analysisManager->FinishNtuple();
+
+  // history of the photons at the readout planes, written with
+  // /opnovice2/run/photonHistory; rows match the photon rows of "t"
+  analysisManager->CreateNtuple("history","optical photon history");
+  analysisManager->CreateNtupleIColumn("evNr");//0
+  analysisManager->CreateNtupleIColumn("tid");//1
+  analysisManager->CreateNtupleIColumn("detID");//2
+  analysisManager->CreateNtupleIColumn("creator");//3 TrackInformation::Creator
+  analysisManager->CreateNtupleIColumn("bounces");//4
+  analysisManager->CreateNtupleIColumn("tir");//5
+  analysisManager->CreateNtupleDColumn("tankPath");//6
+  analysisManager->CreateNtupleIColumn("firstBoundary");//7 boundary status
+  analysisManager->FinishNtuple();
+  analysisManager->SetNtupleActivation(1, false);
   // G4cout<<"Finished ntuple"<<G4endl;
   // std::cin.ignore();
 }
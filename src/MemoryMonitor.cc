@@ -0,0 +1,194 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/src/MemoryMonitor.cc
+/// \brief Implementation of the MemoryMonitor class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "MemoryMonitor.hh"
+#include "ProcessInfo.hh"
+#include "TrackInformation.hh"
+
+#include "G4EventManager.hh"
+#include "G4StackManager.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <iomanip>
+#include <sstream>
+
+namespace {
+  std::atomic<bool> enabled(false);
+
+  G4int    stackBudget     = 0;
+  G4double rssBudget       = 0.;
+  G4double allocatorBudget = 0.;
+  G4int    rowBudget       = 0;
+
+  enum { kStack = 1, kRSS = 2, kAllocator = 4, kRows = 8 };
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+MemoryMonitor::MemoryMonitor()
+  : fEventStack(0), fEventRows(0), fEventRSS(0.),
+    fEvents(0), fMaxStack(0), fSumStack(0.), fMaxRows(0), fSumRows(0.),
+    fMaxAllocator(0.), fMaxRSS(0.), fMaxRSSGrowth(0.), fWarned(0)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+MemoryMonitor::~MemoryMonitor()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void MemoryMonitor::SetEnabled(G4bool value) {enabled = value;}
+
+G4bool MemoryMonitor::IsEnabled()
+{
+  return enabled.load(std::memory_order_relaxed);
+}
+
+void MemoryMonitor::SetStackBudget(G4int tracks) {stackBudget = tracks;}
+void MemoryMonitor::SetRSSBudget(G4double MB) {rssBudget = MB;}
+void MemoryMonitor::SetAllocatorBudget(G4double MB) {allocatorBudget = MB;}
+void MemoryMonitor::SetNtupleRowBudget(G4int rows) {rowBudget = rows;}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void MemoryMonitor::BeginEvent()
+{
+  fEventStack = 0;
+  fEventRows  = 0;
+  fEventRSS   = ProcessInfo::GetResidentMemory();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void MemoryMonitor::SampleStack()
+{
+  // tracks still waiting when the next one starts
+  G4int n = G4EventManager::GetEventManager()->GetStackManager()
+              ->GetNTotalTrack();
+  if (n > fEventStack) fEventStack = n;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void MemoryMonitor::EndEvent(G4int eventID)
+{
+  const G4double rss = ProcessInfo::GetResidentMemory();
+  const G4double allocator = aTrackInformationAllocator
+    ? aTrackInformationAllocator->GetAllocatedSize()/(1024.*1024.) : 0.;
+
+  ++fEvents;
+  fMaxStack      = std::max(fMaxStack, fEventStack);
+  fSumStack     += fEventStack;
+  fMaxRows       = std::max(fMaxRows, fEventRows);
+  fSumRows      += fEventRows;
+  fMaxAllocator  = std::max(fMaxAllocator, allocator);
+  fMaxRSS        = std::max(fMaxRSS, rss);
+  fMaxRSSGrowth  = std::max(fMaxRSSGrowth, rss - fEventRSS);
+
+  std::ostringstream what;
+  if (stackBudget > 0 && fEventStack > stackBudget) {
+    what << "stack depth " << fEventStack << " tracks exceeds "
+         << stackBudget;
+    Warn(kStack, eventID, what.str());
+  }
+  if (rssBudget > 0. && rss > rssBudget) {
+    what.str("");
+    what << "RSS " << rss << " MB exceeds " << rssBudget << " MB";
+    Warn(kRSS, eventID, what.str());
+  }
+  if (allocatorBudget > 0. && allocator > allocatorBudget) {
+    what.str("");
+    what << "TrackInformation pool " << allocator << " MB exceeds "
+         << allocatorBudget << " MB";
+    Warn(kAllocator, eventID, what.str());
+  }
+  if (rowBudget > 0 && fEventRows > rowBudget) {
+    what.str("");
+    what << fEventRows << " ntuple rows exceed " << rowBudget;
+    Warn(kRows, eventID, what.str());
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void MemoryMonitor::Warn(G4int bit, G4int eventID, const G4String& what)
+{
+  if (fWarned & bit) return;
+  fWarned |= bit;
+  G4ExceptionDescription ed;
+  ed << "Memory budget: event " << eventID << ": " << what
+     << " (reported once per run and thread)";
+  G4Exception("MemoryMonitor::EndEvent", "OpNovice2_021", JustWarning, ed);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void MemoryMonitor::Merge(const MemoryMonitor& other)
+{
+  fEvents       += other.fEvents;
+  fMaxStack      = std::max(fMaxStack, other.fMaxStack);
+  fSumStack     += other.fSumStack;
+  fMaxRows       = std::max(fMaxRows, other.fMaxRows);
+  fSumRows      += other.fSumRows;
+  // pools are per thread, so the merged value is their sum
+  fMaxAllocator += other.fMaxAllocator;
+  fMaxRSS        = std::max(fMaxRSS, other.fMaxRSS);
+  fMaxRSSGrowth  = std::max(fMaxRSSGrowth, other.fMaxRSSGrowth);
+  fWarned       |= other.fWarned;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void MemoryMonitor::Print() const
+{
+  if (fEvents == 0) return;
+
+  std::ios::fmtflags mode = G4cout.flags();
+  G4int prec = G4cout.precision(4);
+  G4cout << "\n Memory (" << fEvents << " events):\n"
+         << "  stack depth           max " << std::setw(10) << fMaxStack
+         << "   mean " << fSumStack/fEvents << " tracks\n"
+         << "  ntuple rows per event max " << std::setw(10) << fMaxRows
+         << "   mean " << fSumRows/fEvents << "\n"
+         << "  TrackInformation pools    " << std::setw(10) << fMaxAllocator
+         << " MB (all threads)\n"
+         << "  RSS                   max " << std::setw(10) << fMaxRSS
+         << " MB, largest growth in one event " << fMaxRSSGrowth << " MB"
+         << G4endl;
+  if (fWarned) G4cout << "  memory budget exceeded, see warnings" << G4endl;
+  G4cout.flags(mode);
+  G4cout.precision(prec);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,174 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/src/ParameterSweep.cc
+/// \brief Implementation of the ParameterSweep class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "ParameterSweep.hh"
+#include "ParameterSweepMessenger.hh"
+#include "Run.hh"
+
+#include <fstream>
+#include <sstream>
+
+#include "G4RunManager.hh"
+#include "G4UImanager.hh"
+#include "G4UIcommandStatus.hh"
+#include "G4Timer.hh"
+
+namespace {
+  struct BoundaryColumn {
+    const char* name;
+    G4OpBoundaryProcessStatus status;
+  };
+
+  const BoundaryColumn kBoundaryColumns[] = {
+    {"transmission",            Transmission},
+    {"fresnelRefraction",       FresnelRefraction},
+    {"fresnelReflection",       FresnelReflection},
+    {"totalInternalReflection", TotalInternalReflection},
+    {"lambertianReflection",    LambertianReflection},
+    {"lobeReflection",          LobeReflection},
+    {"spikeReflection",         SpikeReflection},
+    {"backScattering",          BackScattering},
+    {"absorption",              Absorption},
+    {"detection",               Detection}
+  };
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ParameterSweep::ParameterSweep()
+  : fEventsPerPoint(1000),
+    fOutputFile("sweep.csv"),
+    fMessenger(nullptr)
+{
+  fMessenger = new ParameterSweepMessenger(this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ParameterSweep::~ParameterSweep()
+{
+  delete fMessenger;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ParameterSweep::SetValues(const G4String& list)
+{
+  fValues.clear();
+  std::istringstream instring(list);
+  G4String tmp;
+  while (instring >> tmp) {
+    fValues.push_back(tmp);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ParameterSweep::SetGrid(G4double vmin, G4double vmax, G4int npoints)
+{
+  fValues.clear();
+  if (npoints < 1) return;
+  G4double step = (npoints > 1) ? (vmax - vmin)/(npoints - 1) : 0.;
+  for (G4int i = 0; i < npoints; ++i) {
+    fValues.push_back(G4UIcommand::ConvertToString(vmin + i*step));
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ParameterSweep::Execute()
+{
+  if (fCommand.empty() || fValues.empty()) {
+    G4Exception("ParameterSweep::Execute", "OpNovice2_006", JustWarning,
+                "Sweep needs a command template and a list of values.");
+    return;
+  }
+  if (fCommand.find("{value}") == std::string::npos) {
+    G4ExceptionDescription ed;
+    ed << "Sweep command \"" << fCommand << "\" has no {value} placeholder.";
+    G4Exception("ParameterSweep::Execute", "OpNovice2_006", JustWarning, ed);
+    return;
+  }
+
+  std::ofstream out(fOutputFile);
+  out << "# command: " << fCommand << "\n";
+  out << "point,value,events,realTime,cerenkov,scintillation,rayleigh,"
+      << "opAbsorption,absorptionPrior,totalSurface";
+  for (const auto& col : kBoundaryColumns) out << ',' << col.name;
+  out << "\n";
+
+  G4RunManager* runManager = G4RunManager::GetRunManager();
+  G4UImanager* UImanager = G4UImanager::GetUIpointer();
+  G4Timer timer;
+
+  for (size_t i = 0; i < fValues.size(); ++i) {
+    G4String cmd = fCommand;
+    size_t pos;
+    while ((pos = cmd.find("{value}")) != std::string::npos) {
+      cmd.replace(pos, 7, fValues[i]);
+    }
+
+    G4cout << "### Sweep point " << i << ": " << cmd << G4endl;
+    G4int status = UImanager->ApplyCommand(cmd);
+    if (status != fCommandSucceeded) {
+      G4ExceptionDescription ed;
+      ed << "Sweep command \"" << cmd << "\" failed with status " << status
+         << "; skipping point " << i << ".";
+      G4Exception("ParameterSweep::Execute", "OpNovice2_007", JustWarning, ed);
+      continue;
+    }
+
+    timer.Start();
+    runManager->BeamOn(fEventsPerPoint);
+    timer.Stop();
+
+    const Run* run = static_cast<const Run*>(runManager->GetCurrentRun());
+    if (!run) continue;
+
+    out << i << ',' << fValues[i] << ',' << run->GetNumberOfEvent() << ','
+        << timer.GetRealElapsed() << ','
+        << run->GetCerenkovCount() << ',' << run->GetScintillationCount()
+        << ',' << run->GetRayleighCount() << ',' << run->GetOpAbsorption()
+        << ',' << run->GetOpAbsorptionPrior() << ','
+        << run->GetTotalSurface();
+    for (const auto& col : kBoundaryColumns) {
+      out << ',' << run->GetBoundaryProcessCount(col.status);
+    }
+    out << "\n";
+    out.flush();
+  }
+
+  G4cout << "### Sweep of " << fValues.size() << " points written to "
+         << fOutputFile << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
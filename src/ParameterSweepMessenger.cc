@@ -0,0 +1,139 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/src/ParameterSweepMessenger.cc
+/// \brief Implementation of the ParameterSweepMessenger class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "ParameterSweepMessenger.hh"
+#include "ParameterSweep.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithoutParameter.hh"
+
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ParameterSweepMessenger::ParameterSweepMessenger(ParameterSweep* sweep)
+  : G4UImessenger(),
+    fSweep(sweep)
+{
+  fSweepDir = new G4UIdirectory("/opnovice2/sweep/");
+  fSweepDir->SetGuidance("Parameter sweeps within one initialized session.");
+
+  fCommandCmd = new G4UIcmdWithAString("/opnovice2/sweep/command", this);
+  fCommandCmd->SetGuidance("Command applied before each point; {value} is");
+  fCommandCmd->SetGuidance(" replaced by the point value, e.g.");
+  fCommandCmd->SetGuidance(" /opnovice2/surfaceSigmaAlpha {value}");
+  fCommandCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fCommandCmd->SetToBeBroadcasted(false);
+
+  fValuesCmd = new G4UIcmdWithAString("/opnovice2/sweep/values", this);
+  fValuesCmd->SetGuidance("Space delimited list of point values.");
+  fValuesCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fValuesCmd->SetToBeBroadcasted(false);
+
+  fGridCmd = new G4UIcommand("/opnovice2/sweep/grid", this);
+  fGridCmd->SetGuidance("Evenly spaced point values: min max npoints.");
+  G4UIparameter* param = new G4UIparameter("min", 'd', false);
+  fGridCmd->SetParameter(param);
+  param = new G4UIparameter("max", 'd', false);
+  fGridCmd->SetParameter(param);
+  param = new G4UIparameter("npoints", 'i', false);
+  param->SetParameterRange("npoints > 0");
+  fGridCmd->SetParameter(param);
+  fGridCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fGridCmd->SetToBeBroadcasted(false);
+
+  fEventsCmd = new G4UIcmdWithAnInteger("/opnovice2/sweep/events", this);
+  fEventsCmd->SetGuidance("Number of events per point.");
+  fEventsCmd->SetParameterName("events", false);
+  fEventsCmd->SetRange("events > 0");
+  fEventsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fEventsCmd->SetToBeBroadcasted(false);
+
+  fOutputCmd = new G4UIcmdWithAString("/opnovice2/sweep/output", this);
+  fOutputCmd->SetGuidance("CSV file receiving one summary row per point.");
+  fOutputCmd->SetParameterName("fileName", false);
+  fOutputCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fOutputCmd->SetToBeBroadcasted(false);
+
+  fRunCmd = new G4UIcmdWithoutParameter("/opnovice2/sweep/run", this);
+  fRunCmd->SetGuidance("Run all points of the sweep.");
+  fRunCmd->AvailableForStates(G4State_Idle);
+  fRunCmd->SetToBeBroadcasted(false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ParameterSweepMessenger::~ParameterSweepMessenger()
+{
+  delete fCommandCmd;
+  delete fValuesCmd;
+  delete fGridCmd;
+  delete fEventsCmd;
+  delete fOutputCmd;
+  delete fRunCmd;
+  delete fSweepDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ParameterSweepMessenger::SetNewValue(G4UIcommand* command,
+                                          G4String newValue)
+{
+  if (command == fCommandCmd) {
+    fSweep->SetCommand(newValue);
+  }
+  else if (command == fValuesCmd) {
+    fSweep->SetValues(newValue);
+  }
+  else if (command == fGridCmd) {
+    std::istringstream instring(newValue);
+    G4double vmin, vmax;
+    G4int npoints;
+    instring >> vmin >> vmax >> npoints;
+    fSweep->SetGrid(vmin, vmax, npoints);
+  }
+  else if (command == fEventsCmd) {
+    fSweep->SetEventsPerPoint(fEventsCmd->GetNewIntValue(newValue));
+  }
+  else if (command == fOutputCmd) {
+    fSweep->SetOutputFile(newValue);
+  }
+  else if (command == fRunCmd) {
+    fSweep->Execute();
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
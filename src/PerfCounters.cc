@@ -0,0 +1,379 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/src/PerfCounters.cc
+/// \brief Implementation of the PerfCounters class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "PerfCounters.hh"
+
+#include "G4ios.hh"
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <iomanip>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+  std::atomic<bool> enabled(false);
+  std::atomic<bool> sections(false);
+  std::atomic<bool> warned(false);
+
+  const char* counterNames[PerfCounters::kNCounters] = {
+    "cycles", "instructions", "cache misses", "branch misses"
+  };
+
+  const char* sectionNames[PerfCounters::kNSections] = {
+    "stepping action", "tracking actions", "event actions"
+  };
+
+  // counter group of this thread; the first counter that opens leads it
+  struct ThreadCounters {
+    G4int         fd[PerfCounters::kNCounters];   // -1 if not open
+    G4int         leader;
+    G4int         nOpen;
+    G4int         available;
+    G4double      last[PerfCounters::kNCounters];
+    PerfCounters* owner;
+  };
+
+  G4ThreadLocal ThreadCounters* current = nullptr;
+
+  //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+  void Warn(const G4String& reason)
+  {
+    if (warned.exchange(true)) return;
+    G4ExceptionDescription ed;
+    ed << "Hardware performance counters are not available: " << reason
+       << G4endl
+       << "The run continues without them. On Linux, check"
+       << " /proc/sys/kernel/perf_event_paranoid (2 or lower is needed)"
+       << " and, in containers, that perf_event_open is permitted.";
+    G4Exception("PerfCounters::BeginRun", "OpNovice2_022", JustWarning, ed);
+  }
+
+  //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifdef __linux__
+  const uint64_t configs[PerfCounters::kNCounters] = {
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_MISSES
+  };
+#endif
+
+  ThreadCounters* Open()
+  {
+#ifdef __linux__
+    ThreadCounters* counters = new ThreadCounters;
+    counters->leader = -1;
+    counters->nOpen = 0;
+    counters->available = 0;
+    counters->owner = nullptr;
+    G4int error = 0;
+    for (G4int i = 0; i < PerfCounters::kNCounters; ++i) {
+      counters->fd[i] = -1;
+      counters->last[i] = 0.;
+      perf_event_attr attr;
+      std::memset(&attr, 0, sizeof(attr));
+      attr.size = sizeof(attr);
+      attr.type = PERF_TYPE_HARDWARE;
+      attr.config = configs[i];
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      attr.read_format = PERF_FORMAT_GROUP |
+                         PERF_FORMAT_TOTAL_TIME_ENABLED |
+                         PERF_FORMAT_TOTAL_TIME_RUNNING;
+      // calling thread only, on any CPU
+      long fd = syscall(__NR_perf_event_open, &attr, 0, -1,
+                        counters->leader, 0);
+      if (fd < 0) {
+        error = errno;
+        continue;
+      }
+      counters->fd[i] = fd;
+      if (counters->leader < 0) counters->leader = fd;
+      counters->available |= 1 << i;
+      ++counters->nOpen;
+    }
+    if (counters->nOpen == 0) {
+      delete counters;
+      Warn(G4String("perf_event_open failed: ") + std::strerror(error));
+      return nullptr;
+    }
+    return counters;
+#else
+    Warn("perf_event_open is Linux only");
+    return nullptr;
+#endif
+  }
+
+  //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+  // counts since the group was opened, scaled up if the kernel had to
+  // multiplex the counters
+  void Read(const ThreadCounters* counters, G4double values[])
+  {
+    for (G4int i = 0; i < PerfCounters::kNCounters; ++i) values[i] = 0.;
+#ifdef __linux__
+    uint64_t buffer[3 + PerfCounters::kNCounters];
+    ssize_t size = read(counters->leader, buffer, sizeof(buffer));
+    if (size < static_cast<ssize_t>(3*sizeof(uint64_t))) return;
+    G4double scale = buffer[2] > 0 ? G4double(buffer[1])/buffer[2] : 0.;
+    // values come in the order the counters joined the group
+    G4int k = 0;
+    for (G4int i = 0; i < PerfCounters::kNCounters; ++i) {
+      if (counters->fd[i] < 0) continue;
+      if (k < G4int(buffer[0])) values[i] = buffer[3 + k]*scale;
+      ++k;
+    }
+#else
+    (void)counters;
+#endif
+  }
+
+  //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+  void Close(ThreadCounters* counters)
+  {
+#ifdef __linux__
+    for (G4int i = PerfCounters::kNCounters - 1; i >= 0; --i) {
+      if (counters->fd[i] >= 0) close(counters->fd[i]);
+    }
+#endif
+    delete counters;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4ThreadLocal G4bool PerfCounters::fCountSections = false;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+PerfCounters::PerfCounters()
+  : fThreads(0), fAvailable(0)
+{
+  for (G4int i = 0; i < kNCounters; ++i) {
+    fRun[i] = 0.;
+    for (G4int s = 0; s < kNSections; ++s) fSection[s][i] = 0.;
+  }
+  for (G4int s = 0; s < kNSections; ++s) fCalls[s] = 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+PerfCounters::~PerfCounters()
+{
+  if (current && current->owner == this) {
+    current->owner = nullptr;
+    fCountSections = false;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PerfCounters::SetEnabled(G4bool value) {enabled = value;}
+
+G4bool PerfCounters::IsEnabled()
+{
+  return enabled.load(std::memory_order_relaxed);
+}
+
+void PerfCounters::SetSections(G4bool value) {sections = value;}
+
+const char* PerfCounters::GetCounterName(Counter c) {return counterNames[c];}
+
+const char* PerfCounters::GetSectionName(Section s) {return sectionNames[s];}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PerfCounters::BeginRun()
+{
+  EndRun();
+  if (!IsEnabled()) return;
+  current = Open();
+  if (!current) return;
+  current->owner = this;
+  fCountSections = sections.load(std::memory_order_relaxed);
+  fThreads = 1;
+  fAvailable = current->available;
+  Read(current, current->last);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PerfCounters::EndEvent()
+{
+  if (!current || current->owner != this) return;
+  G4double now[kNCounters];
+  Read(current, now);
+  for (G4int i = 0; i < kNCounters; ++i) {
+    fRun[i] += now[i] - current->last[i];
+    current->last[i] = now[i];
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PerfCounters::EndRun()
+{
+  fCountSections = false;
+  if (!current) return;
+  Close(current);
+  current = nullptr;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PerfCounters::Scope::Start()
+{
+  Read(current, fStart);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PerfCounters::Scope::Stop()
+{
+  if (!current || !current->owner) return;
+  G4double now[kNCounters];
+  Read(current, now);
+  PerfCounters* owner = current->owner;
+  for (G4int i = 0; i < kNCounters; ++i) {
+    owner->fSection[fSection][i] += now[i] - fStart[i];
+  }
+  ++owner->fCalls[fSection];
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PerfCounters::Merge(const PerfCounters& other)
+{
+  if (other.fThreads == 0) return;
+  fAvailable = fThreads ? (fAvailable & other.fAvailable) : other.fAvailable;
+  fThreads += other.fThreads;
+  for (G4int i = 0; i < kNCounters; ++i) {
+    fRun[i] += other.fRun[i];
+    for (G4int s = 0; s < kNSections; ++s) {
+      fSection[s][i] += other.fSection[s][i];
+    }
+  }
+  for (G4int s = 0; s < kNSections; ++s) fCalls[s] += other.fCalls[s];
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool PerfCounters::IsAvailable(Counter c) const
+{
+  return fThreads > 0 && (fAvailable & (1 << c));
+}
+
+G4double PerfCounters::GetIPC() const
+{
+  if (!IsAvailable(kCycles) || !IsAvailable(kInstructions)) return 0.;
+  return fRun[kCycles] > 0. ? fRun[kInstructions]/fRun[kCycles] : 0.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PerfCounters::Print(G4long steps) const
+{
+  if (fThreads == 0) {
+    if (IsEnabled()) {
+      G4cout << "\n Hardware counters: not available" << G4endl;
+    }
+    return;
+  }
+
+  std::ios::fmtflags mode = G4cout.flags();
+  G4int prec = G4cout.precision(4);
+
+  G4cout << "\n Hardware counters of the event loop (" << fThreads
+         << " thread(s), user space):" << G4endl;
+  for (G4int i = 0; i < kNCounters; ++i) {
+    G4cout << "  " << std::setw(14) << std::left << counterNames[i]
+           << std::right;
+    if (!IsAvailable(Counter(i))) {
+      G4cout << " not available" << G4endl;
+      continue;
+    }
+    G4cout << std::setw(14) << fRun[i];
+    if (steps > 0) G4cout << "  " << fRun[i]/steps << " per step";
+    G4cout << G4endl;
+  }
+  if (GetIPC() > 0.) G4cout << "  IPC " << GetIPC() << G4endl;
+
+  G4long calls = 0;
+  for (G4int s = 0; s < kNSections; ++s) calls += fCalls[s];
+  if (calls > 0 && IsAvailable(kCycles)) {
+    G4cout << "  " << std::setw(20) << std::left << "section" << std::right
+           << std::setw(12) << "calls" << std::setw(10) << "cycles %"
+           << std::setw(8) << "IPC" << std::setw(16) << "cache m./call"
+           << std::setw(16) << "branch m./call" << G4endl;
+    G4double rest[kNCounters];
+    for (G4int i = 0; i < kNCounters; ++i) rest[i] = fRun[i];
+    for (G4int s = 0; s <= kNSections; ++s) {
+      // the last row is what the sections leave: Geant4 itself
+      const G4double* v = s < kNSections ? fSection[s] : rest;
+      G4long n = s < kNSections ? fCalls[s] : 0;
+      if (s < kNSections) {
+        if (n == 0) continue;
+        for (G4int i = 0; i < kNCounters; ++i) rest[i] -= v[i];
+      }
+      G4cout << "  " << std::setw(20) << std::left
+             << (s < kNSections ? sectionNames[s] : "Geant4 (rest)")
+             << std::right << std::setw(12);
+      if (n > 0) G4cout << n;
+      else G4cout << "-";
+      G4cout << std::setw(10)
+             << (fRun[kCycles] > 0. ? 100.*v[kCycles]/fRun[kCycles] : 0.)
+             << std::setw(8)
+             << (v[kCycles] > 0. ? v[kInstructions]/v[kCycles] : 0.);
+      for (G4int i = kCacheMisses; i <= kBranchMisses; ++i) {
+        G4cout << std::setw(16);
+        if (n > 0) G4cout << v[i]/n;
+        else G4cout << "-";
+      }
+      G4cout << G4endl;
+    }
+  }
+
+  G4cout.flags(mode);
+  G4cout.precision(prec);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
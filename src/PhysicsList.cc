@@ -0,0 +1,295 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/src/PhysicsList.cc
+/// \brief Implementation of the PhysicsList class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "PhysicsList.hh"
+#include "PhysicsTableCache.hh"
+#include "PhysicsListMessenger.hh"
+
+#include "G4OpticalPhysics.hh"
+#include "G4OpticalProcessIndex.hh"
+#include "G4Cerenkov.hh"
+#include "G4Scintillation.hh"
+#include "G4ProcessTable.hh"
+#include "G4StateManager.hh"
+#include "G4StepLimiterPhysics.hh"
+#include "G4EmStandardPhysics_option4.hh"
+#include "G4EmExtraPhysics.hh"
+#include "G4DecayPhysics.hh"
+#include "G4HadronElasticPhysics.hh"
+#include "G4HadronPhysicsFTFP_BERT.hh"
+#include "G4StoppingPhysics.hh"
+#include "G4IonPhysics.hh"
+#include "G4NeutronTrackingCut.hh"
+
+#include "G4Electron.hh"
+#include "G4Positron.hh"
+#include "G4Gamma.hh"
+#include "G4Geantino.hh"
+#include "G4ChargedGeantino.hh"
+
+#include "G4SystemOfUnits.hh"
+#include "G4Threading.hh"
+
+namespace {
+  // in the order of G4OpticalProcessIndex
+  const char* kOpticalProcessNames[] = {
+    "Cerenkov", "Scintillation", "OpAbsorption", "OpRayleigh",
+    "OpMieHG", "OpBoundary", "OpWLS"
+  };
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+PhysicsList::PhysicsList(const G4String& mode)
+  : G4VModularPhysicsList(),
+    fMode(mode),
+    fTableCache(nullptr),
+    fOpticalPhysics(nullptr),
+    fStepLimiter(nullptr),
+    fMessenger(nullptr),
+    fCerenkovMaxPhotons(-1),
+    fCerenkovMaxBetaChange(-1.),
+    fCerenkovTrackSecondariesFirst(-1),
+    fScintTrackSecondariesFirst(-1),
+    fScintYieldFactor(-1.)
+{
+  for (G4int i = 0; i < kNOpticalProcesses; ++i) fOpticalActive[i] = -1;
+
+  if (!IsValidMode(fMode)) {
+    G4ExceptionDescription ed;
+    ed << "Unknown physics mode " << fMode
+       << "; use optical, em or full. Using full.";
+    G4Exception("PhysicsList::PhysicsList", "OpNovice2_012", JustWarning, ed);
+    fMode = "full";
+  }
+
+  SetDefaultCutValue(0.7*mm);
+
+  if (fMode == "em" || fMode == "full") {
+    RegisterPhysics(new G4EmStandardPhysics_option4());
+  }
+  if (fMode == "full") {
+    // the hadronic part of FTFP_BERT
+    RegisterPhysics(new G4EmExtraPhysics());
+    RegisterPhysics(new G4DecayPhysics());
+    RegisterPhysics(new G4HadronElasticPhysics());
+    RegisterPhysics(new G4HadronPhysicsFTFP_BERT());
+    RegisterPhysics(new G4StoppingPhysics());
+    RegisterPhysics(new G4IonPhysics());
+    RegisterPhysics(new G4NeutronTrackingCut());
+  }
+
+  fOpticalPhysics = new G4OpticalPhysics();
+  RegisterPhysics(fOpticalPhysics);
+
+  // enforces the per-region limits of /opnovice2/region/ on charged
+  // particles; optical photons take millions of steps and only get the
+  // extra process with /opnovice2/physics/limitNeutrals
+  fStepLimiter = new G4StepLimiterPhysics();
+  RegisterPhysics(fStepLimiter);
+
+  fMessenger = new PhysicsListMessenger(this);
+
+  G4cout << "PhysicsList: " << fMode << " mode" << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+PhysicsList::~PhysicsList()
+{
+  delete fTableCache;
+  delete fMessenger;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhysicsList::ConstructParticle()
+{
+  G4VModularPhysicsList::ConstructParticle();
+
+  // Without EM physics nothing defines the default gun particle (e-);
+  // the definitions are cheap, the particles are only transported.
+  G4Electron::ElectronDefinition();
+  G4Positron::PositronDefinition();
+  G4Gamma::GammaDefinition();
+  G4Geantino::GeantinoDefinition();
+  G4ChargedGeantino::ChargedGeantinoDefinition();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhysicsList::SetCuts()
+{
+  G4VModularPhysicsList::SetCuts();
+
+  // geometry, materials and cuts are final here and the tables are not
+  // built yet, so this is where the cache entry is chosen
+  if (fTableCache && G4Threading::IsMasterThread()) {
+    fTableCache->Prepare(this, fMode);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhysicsList::SetTableCache(const G4String& rootDir)
+{
+  delete fTableCache;
+  fTableCache = new PhysicsTableCache(rootDir);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhysicsList::StoreTableCache()
+{
+  if (fTableCache) fTableCache->Store(this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhysicsList::CutsChanged()
+{
+  if (fTableCache) fTableCache->Invalidate(this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhysicsList::SetLimitNeutrals(G4bool value)
+{
+  // the processes are attached at /run/initialize
+  fStepLimiter->SetApplyToAll(value);
+  G4cout << "Region limits apply to "
+         << (value ? "all particles" : "charged particles") << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool PhysicsList::SetOpticalProcessActive(const G4String& process,
+                                            G4bool active)
+{
+  G4int index = 0;
+  while (index < kNOpticalProcesses &&
+         process != kOpticalProcessNames[index]) ++index;
+  if (index == kNOpticalProcesses) {
+    G4ExceptionDescription ed;
+    ed << "Unknown optical process " << process;
+    G4Exception("PhysicsList::SetOpticalProcessActive", "OpNovice2_014",
+                JustWarning, ed);
+    return false;
+  }
+
+  if (G4StateManager::GetStateManager()->GetCurrentState() == G4State_PreInit)
+  {
+    fOpticalPhysics->Configure(G4OpticalProcessIndex(index), active);
+  }
+  fOpticalActive[index] = active;
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhysicsList::ApplyOpticalSettings() const
+{
+  G4ProcessTable* table = G4ProcessTable::GetProcessTable();
+  for (G4int i = 0; i < kNOpticalProcesses; ++i) {
+    if (fOpticalActive[i] < 0) continue;
+    // processes removed before initialization are not in the table
+    G4ProcessVector* procs = table->FindProcesses(kOpticalProcessNames[i]);
+    if (procs->entries() > 0) {
+      table->SetProcessActivation(kOpticalProcessNames[i],
+                                  fOpticalActive[i] > 0);
+    }
+    delete procs;
+  }
+
+  G4ProcessVector* cerenkov = table->FindProcesses("Cerenkov");
+  for (G4int i = 0; i < cerenkov->entries(); ++i) {
+    G4Cerenkov* proc = dynamic_cast<G4Cerenkov*>((*cerenkov)[i]);
+    if (!proc) continue;
+    if (fCerenkovMaxPhotons >= 0) {
+      proc->SetMaxNumPhotonsPerStep(fCerenkovMaxPhotons);
+    }
+    if (fCerenkovMaxBetaChange >= 0.) {
+      proc->SetMaxBetaChangePerStep(fCerenkovMaxBetaChange);
+    }
+    if (fCerenkovTrackSecondariesFirst >= 0) {
+      proc->SetTrackSecondariesFirst(fCerenkovTrackSecondariesFirst > 0);
+    }
+  }
+  delete cerenkov;
+
+  G4ProcessVector* scint = table->FindProcesses("Scintillation");
+  for (G4int i = 0; i < scint->entries(); ++i) {
+    G4Scintillation* proc = dynamic_cast<G4Scintillation*>((*scint)[i]);
+    if (!proc) continue;
+    if (fScintTrackSecondariesFirst >= 0) {
+      proc->SetTrackSecondariesFirst(fScintTrackSecondariesFirst > 0);
+    }
+    if (fScintYieldFactor >= 0.) {
+      proc->SetScintillationYieldFactor(fScintYieldFactor);
+    }
+  }
+  delete scint;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhysicsList::PrintOpticalSettings() const
+{
+  G4cout << "Optical processes (" << fMode << " physics):";
+  for (G4int i = 0; i < kNOpticalProcesses; ++i) {
+    G4cout << " " << kOpticalProcessNames[i] << "="
+           << (fOpticalActive[i] < 0 ? "default"
+               : (fOpticalActive[i] > 0 ? "on" : "off"));
+  }
+  G4cout << G4endl << "  Cerenkov maxPhotons ";
+  if (fCerenkovMaxPhotons >= 0) G4cout << fCerenkovMaxPhotons;
+  else G4cout << "default";
+  G4cout << ", maxBetaChange ";
+  if (fCerenkovMaxBetaChange >= 0.) G4cout << fCerenkovMaxBetaChange << " %";
+  else G4cout << "default";
+  G4cout << ", trackSecondariesFirst Cerenkov/scint "
+         << fCerenkovTrackSecondariesFirst << "/"
+         << fScintTrackSecondariesFirst << " (-1 default)"
+         << ", scint yield factor ";
+  if (fScintYieldFactor >= 0.) G4cout << fScintYieldFactor;
+  else G4cout << "default";
+  G4cout << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool PhysicsList::IsValidMode(const G4String& mode)
+{
+  return mode == "optical" || mode == "em" || mode == "full";
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,188 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/src/PhysicsListMessenger.cc
+/// \brief Implementation of the PhysicsListMessenger class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "PhysicsListMessenger.hh"
+#include "PhysicsList.hh"
+
+#include <sstream>
+
+#include "G4UIdirectory.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithADouble.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithoutParameter.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+PhysicsListMessenger::PhysicsListMessenger(PhysicsList* physics)
+  : G4UImessenger(),
+    fPhysicsList(physics)
+{
+  // The settings are kept in the (shared) physics list and applied by
+  // every thread at the start of a run, so none of these is broadcast.
+  fPhysicsDir = new G4UIdirectory("/opnovice2/physics/");
+  fPhysicsDir->SetGuidance("Optical process control.");
+
+  fActivateCmd = new G4UIcommand("/opnovice2/physics/activate", this);
+  fActivateCmd->SetGuidance("Switch an optical process on or off. Before");
+  fActivateCmd->SetGuidance(" /run/initialize a process switched off is");
+  fActivateCmd->SetGuidance(" not constructed at all.");
+  G4UIparameter* param = new G4UIparameter("process", 's', false);
+  param->SetParameterCandidates("Cerenkov Scintillation OpAbsorption "
+                                "OpRayleigh OpMieHG OpBoundary OpWLS");
+  fActivateCmd->SetParameter(param);
+  param = new G4UIparameter("active", 'b', true);
+  param->SetDefaultValue("true");
+  fActivateCmd->SetParameter(param);
+  fActivateCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fActivateCmd->SetToBeBroadcasted(false);
+
+  fCerenkovMaxPhotonsCmd =
+    new G4UIcmdWithAnInteger("/opnovice2/physics/cerenkovMaxPhotons", this);
+  fCerenkovMaxPhotonsCmd->SetGuidance("Maximum number of Cerenkov photons");
+  fCerenkovMaxPhotonsCmd->SetGuidance(" per step (limits the step).");
+  fCerenkovMaxPhotonsCmd->SetParameterName("n", false);
+  fCerenkovMaxPhotonsCmd->SetRange("n > 0");
+  fCerenkovMaxPhotonsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fCerenkovMaxPhotonsCmd->SetToBeBroadcasted(false);
+
+  fCerenkovMaxBetaChangeCmd =
+    new G4UIcmdWithADouble("/opnovice2/physics/cerenkovMaxBetaChange", this);
+  fCerenkovMaxBetaChangeCmd->SetGuidance("Maximum change of beta of the");
+  fCerenkovMaxBetaChangeCmd->SetGuidance(" parent per step, in percent.");
+  fCerenkovMaxBetaChangeCmd->SetParameterName("percent", false);
+  fCerenkovMaxBetaChangeCmd->SetRange("percent > 0");
+  fCerenkovMaxBetaChangeCmd->AvailableForStates(G4State_PreInit,
+                                                G4State_Idle);
+  fCerenkovMaxBetaChangeCmd->SetToBeBroadcasted(false);
+
+  fCerenkovTrackSecondariesFirstCmd = new G4UIcmdWithABool(
+    "/opnovice2/physics/cerenkovTrackSecondariesFirst", this);
+  fCerenkovTrackSecondariesFirstCmd->SetGuidance("Track Cerenkov photons");
+  fCerenkovTrackSecondariesFirstCmd->SetGuidance(" before the parent.");
+  fCerenkovTrackSecondariesFirstCmd->SetParameterName("flag", false);
+  fCerenkovTrackSecondariesFirstCmd->AvailableForStates(G4State_PreInit,
+                                                        G4State_Idle);
+  fCerenkovTrackSecondariesFirstCmd->SetToBeBroadcasted(false);
+
+  fScintTrackSecondariesFirstCmd = new G4UIcmdWithABool(
+    "/opnovice2/physics/scintTrackSecondariesFirst", this);
+  fScintTrackSecondariesFirstCmd->SetGuidance("Track scintillation photons");
+  fScintTrackSecondariesFirstCmd->SetGuidance(" before the parent.");
+  fScintTrackSecondariesFirstCmd->SetParameterName("flag", false);
+  fScintTrackSecondariesFirstCmd->AvailableForStates(G4State_PreInit,
+                                                     G4State_Idle);
+  fScintTrackSecondariesFirstCmd->SetToBeBroadcasted(false);
+
+  fScintYieldFactorCmd =
+    new G4UIcmdWithADouble("/opnovice2/physics/scintYieldFactor", this);
+  fScintYieldFactorCmd->SetGuidance("Scale factor of the scintillation yield.");
+  fScintYieldFactorCmd->SetParameterName("factor", false);
+  fScintYieldFactorCmd->SetRange("factor >= 0");
+  fScintYieldFactorCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fScintYieldFactorCmd->SetToBeBroadcasted(false);
+
+  fPrintCmd = new G4UIcmdWithoutParameter("/opnovice2/physics/print", this);
+  fPrintCmd->SetGuidance("Print the optical process settings.");
+  fPrintCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fPrintCmd->SetToBeBroadcasted(false);
+
+  fLimitNeutralsCmd =
+    new G4UIcmdWithABool("/opnovice2/physics/limitNeutrals", this);
+  fLimitNeutralsCmd->SetGuidance("Apply the /opnovice2/region/ limits also to");
+  fLimitNeutralsCmd->SetGuidance(" neutral particles and optical photons;");
+  fLimitNeutralsCmd->SetGuidance(" adds a process to every photon step.");
+  fLimitNeutralsCmd->SetParameterName("flag", true);
+  fLimitNeutralsCmd->SetDefaultValue(true);
+  fLimitNeutralsCmd->AvailableForStates(G4State_PreInit);
+  fLimitNeutralsCmd->SetToBeBroadcasted(false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+PhysicsListMessenger::~PhysicsListMessenger()
+{
+  delete fActivateCmd;
+  delete fCerenkovMaxPhotonsCmd;
+  delete fCerenkovMaxBetaChangeCmd;
+  delete fCerenkovTrackSecondariesFirstCmd;
+  delete fScintTrackSecondariesFirstCmd;
+  delete fScintYieldFactorCmd;
+  delete fPrintCmd;
+  delete fLimitNeutralsCmd;
+  delete fPhysicsDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhysicsListMessenger::SetNewValue(G4UIcommand* command,
+                                       G4String newValue)
+{
+  if (command == fActivateCmd) {
+    G4String process, flag;
+    std::istringstream instring(newValue);
+    instring >> process >> flag;
+    fPhysicsList->SetOpticalProcessActive(process,
+                                          G4UIcommand::ConvertToBool(flag));
+  }
+  else if (command == fCerenkovMaxPhotonsCmd) {
+    fPhysicsList->SetCerenkovMaxPhotons(
+      fCerenkovMaxPhotonsCmd->GetNewIntValue(newValue));
+  }
+  else if (command == fCerenkovMaxBetaChangeCmd) {
+    fPhysicsList->SetCerenkovMaxBetaChange(
+      fCerenkovMaxBetaChangeCmd->GetNewDoubleValue(newValue));
+  }
+  else if (command == fCerenkovTrackSecondariesFirstCmd) {
+    fPhysicsList->SetCerenkovTrackSecondariesFirst(
+      fCerenkovTrackSecondariesFirstCmd->GetNewBoolValue(newValue));
+  }
+  else if (command == fScintTrackSecondariesFirstCmd) {
+    fPhysicsList->SetScintTrackSecondariesFirst(
+      fScintTrackSecondariesFirstCmd->GetNewBoolValue(newValue));
+  }
+  else if (command == fScintYieldFactorCmd) {
+    fPhysicsList->SetScintYieldFactor(
+      fScintYieldFactorCmd->GetNewDoubleValue(newValue));
+  }
+  else if (command == fPrintCmd) {
+    fPhysicsList->PrintOpticalSettings();
+  }
+  else if (command == fLimitNeutralsCmd) {
+    fPhysicsList->SetLimitNeutrals(
+      fLimitNeutralsCmd->GetNewBoolValue(newValue));
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
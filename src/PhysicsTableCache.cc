@@ -0,0 +1,227 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/src/PhysicsTableCache.cc
+/// \brief Implementation of the PhysicsTableCache class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "PhysicsTableCache.hh"
+
+#include "G4VUserPhysicsList.hh"
+#include "G4Material.hh"
+#include "G4Element.hh"
+#include "G4IonisParamMat.hh"
+#include "G4EmParameters.hh"
+#include "G4Region.hh"
+#include "G4RegionStore.hh"
+#include "G4ProductionCuts.hh"
+#include "G4ProductionCutsTable.hh"
+#include "G4Version.hh"
+
+#include <cerrno>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+  G4bool IsDirectory(const G4String& path)
+  {
+    struct stat st;
+    return stat(path.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+  }
+
+  // the tables are plain files in one directory level
+  void RemoveDirectory(const G4String& path)
+  {
+    DIR* dir = opendir(path.c_str());
+    if (!dir) return;
+    while (dirent* entry = readdir(dir)) {
+      G4String name = entry->d_name;
+      if (name == "." || name == "..") continue;
+      std::remove((path + "/" + name).c_str());
+    }
+    closedir(dir);
+    rmdir(path.c_str());
+  }
+
+  // 64 bit FNV-1a
+  G4String Hash(const G4String& text)
+  {
+    unsigned long long h = 14695981039346656037ULL;
+    for (unsigned char c : text) {
+      h ^= c;
+      h *= 1099511628211ULL;
+    }
+    std::ostringstream os;
+    os << std::hex << std::setw(16) << std::setfill('0') << h;
+    return os.str();
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+PhysicsTableCache::PhysicsTableCache(const G4String& rootDir)
+  : fRootDir(rootDir),
+    fRetrieved(false),
+    fStored(false)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+PhysicsTableCache::~PhysicsTableCache()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4String PhysicsTableCache::BuildKey(const G4String& mode) const
+{
+  std::ostringstream os;
+  os << std::setprecision(17);
+  os << G4VERSION_NUMBER << " " << mode << "\n";
+  // msc options, energy limits and the /process/em* and /process/eLoss/*
+  // settings all shape the EM tables
+  G4EmParameters::Instance()->StreamInfo(os);
+
+  const G4MaterialTable* materials = G4Material::GetMaterialTable();
+  for (const G4Material* mat : *materials) {
+    os << mat->GetName() << " " << mat->GetDensity() << " "
+       << mat->GetTemperature() << " " << mat->GetPressure() << " "
+       << mat->GetState() << " "
+       << mat->GetIonisation()->GetMeanExcitationEnergy();
+    const G4double* fractions = mat->GetFractionVector();
+    for (size_t i = 0; i < mat->GetNumberOfElements(); ++i) {
+      const G4Element* el = mat->GetElement(i);
+      os << " " << el->GetZ() << ":" << el->GetN() << ":" << fractions[i];
+    }
+    os << "\n";
+  }
+
+  const G4ProductionCuts* defaultCuts = G4ProductionCutsTable::
+    GetProductionCutsTable()->GetDefaultProductionCuts();
+  for (const G4Region* region : *G4RegionStore::GetInstance()) {
+    const G4ProductionCuts* cuts = region->GetProductionCuts();
+    if (!cuts) cuts = defaultCuts;
+    os << region->GetName();
+    for (G4int i = 0; i < 4; ++i) os << " " << cuts->GetProductionCut(i);
+    os << "\n";
+  }
+  return os.str();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhysicsTableCache::Prepare(G4VUserPhysicsList* physics,
+                                const G4String& mode)
+{
+  fMode      = mode;
+  fKey       = BuildKey(mode);
+  fEntryDir  = fRootDir + "/" + Hash(fKey);
+  fRetrieved = false;
+  fStored    = false;
+
+  // a hit needs the complete entry and the same key text, which also
+  // rules out hash collisions
+  std::ifstream keyFile(fEntryDir + "/key.txt");
+  if (keyFile) {
+    std::stringstream stored;
+    stored << keyFile.rdbuf();
+    fRetrieved = (stored.str() == fKey);
+  }
+
+  if (fRetrieved) {
+    physics->SetPhysicsTableRetrieved(fEntryDir);
+    G4cout << "Physics tables are retrieved from " << fEntryDir << G4endl;
+  }
+  else {
+    G4cout << "Physics tables will be stored in " << fEntryDir << G4endl;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhysicsTableCache::Invalidate(G4VUserPhysicsList* physics)
+{
+  if (fKey.empty() || BuildKey(fMode) == fKey) return;
+  if (fRetrieved) {
+    physics->ResetPhysicsTableRetrieved();
+    fRetrieved = false;
+    G4cout << "Production cuts changed, the cached physics tables in "
+           << fEntryDir << " are not used" << G4endl;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhysicsTableCache::Store(G4VUserPhysicsList* physics)
+{
+  if (fRetrieved || fStored || fKey.empty()) return;
+  fStored = true;
+
+  // the tables were built with the cuts of now, not those of Prepare
+  G4String key = BuildKey(fMode);
+  if (key != fKey) {
+    fKey      = key;
+    fEntryDir = fRootDir + "/" + Hash(fKey);
+  }
+
+  if (!IsDirectory(fRootDir) && mkdir(fRootDir.c_str(), 0755) != 0) {
+    G4ExceptionDescription ed;
+    ed << "Cannot create the physics table cache " << fRootDir;
+    G4Exception("PhysicsTableCache::Store", "OpNovice2_013", JustWarning, ed);
+    return;
+  }
+
+  std::ostringstream tmp;
+  tmp << fEntryDir << ".tmp." << getpid();
+  G4String tmpDir = tmp.str();
+  if (mkdir(tmpDir.c_str(), 0755) != 0 || !physics->StorePhysicsTable(tmpDir))
+  {
+    G4ExceptionDescription ed;
+    ed << "Cannot store the physics tables in " << tmpDir;
+    G4Exception("PhysicsTableCache::Store", "OpNovice2_013", JustWarning, ed);
+    RemoveDirectory(tmpDir);
+    return;
+  }
+  std::ofstream(tmpDir + "/key.txt") << fKey;
+
+  // another job may have stored the same entry meanwhile; either copy
+  // is complete, so losing the race is harmless
+  if (rename(tmpDir.c_str(), fEntryDir.c_str()) != 0) {
+    RemoveDirectory(tmpDir);
+  }
+  else {
+    G4cout << "Physics tables stored in " << fEntryDir << G4endl;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,357 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/src/PrimaryFileReader.cc
+/// \brief Implementation of the PrimaryFileReader class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "PrimaryFileReader.hh"
+
+#include "G4AutoLock.hh"
+#include "G4Event.hh"
+#include "G4OpticalPhoton.hh"
+#include "G4ParticleTable.hh"
+#include "G4PrimaryParticle.hh"
+#include "G4PrimaryVertex.hh"
+#include "G4SystemOfUnits.hh"
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+  G4Mutex readerMutex = G4MUTEX_INITIALIZER;
+  std::map<G4String, std::unique_ptr<PrimaryFileReader> > readers;
+
+  const char     kBinaryMagic[8] = {'O','P','N','2','P','R','I','M'};
+  const uint32_t kBinaryVersion  = 1;
+  const size_t   kHeaderSize     = 16;
+  const size_t   kRecordSize     = 2*sizeof(int32_t) + 11*sizeof(double);
+
+  inline G4bool IsBlank(char c)
+  { return c == ' ' || c == '\t' || c == '\r'; }
+
+  // end of the line starting at p
+  inline const char* LineEnd(const char* p, const char* end)
+  {
+    const void* nl = std::memchr(p, '\n', end - p);
+    return nl ? static_cast<const char*>(nl) : end;
+  }
+
+  // true for a line holding nothing but blanks or a comment
+  inline G4bool IsEmptyLine(const char* p, const char* eol)
+  {
+    while (p < eol && IsBlank(*p)) ++p;
+    return p == eol || *p == '#';
+  }
+
+  // next number on the line; the token is copied since the mapping
+  // need not be terminated
+  G4bool NextNumber(const char*& p, const char* eol, G4double& value)
+  {
+    while (p < eol && IsBlank(*p)) ++p;
+    const char* q = p;
+    while (q < eol && !IsBlank(*q) && *q != '#') ++q;
+    char token[64];
+    if (q == p || q - p >= (long)sizeof(token)) return false;
+    std::memcpy(token, p, q - p);
+    token[q - p] = '\0';
+    char* stop;
+    value = std::strtod(token, &stop);
+    p = q;
+    return *stop == '\0';
+  }
+
+  template <class T>
+  inline T ReadPOD(const char* p)
+  {
+    T value;
+    std::memcpy(&value, p, sizeof(T));
+    return value;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const PrimaryFileReader* PrimaryFileReader::Open(const G4String& fileName)
+{
+  G4AutoLock lock(&readerMutex);
+  std::unique_ptr<PrimaryFileReader>& reader = readers[fileName];
+  if (!reader) reader.reset(new PrimaryFileReader(fileName));
+  return reader.get();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+PrimaryFileReader::PrimaryFileReader(const G4String& fileName)
+  : fFileName(fileName),
+    fData(nullptr),
+    fSize(0),
+    fBinary(false),
+    fExhausted(false)
+{
+  G4int fd = open(fileName.c_str(), O_RDONLY);
+  struct stat st;
+  if (fd < 0 || fstat(fd, &st) != 0 || st.st_size == 0) {
+    if (fd >= 0) close(fd);
+    G4ExceptionDescription ed;
+    ed << "Cannot open primary file " << fileName << " or it is empty";
+    G4Exception("PrimaryFileReader::PrimaryFileReader", "OpNovice2_016",
+                FatalException, ed);
+    return;
+  }
+  fSize = st.st_size;
+  void* data = mmap(nullptr, fSize, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    G4ExceptionDescription ed;
+    ed << "Cannot map primary file " << fileName;
+    G4Exception("PrimaryFileReader::PrimaryFileReader", "OpNovice2_016",
+                FatalException, ed);
+    fSize = 0;
+    return;
+  }
+  // events are mostly consumed in file order: let the kernel read ahead
+  madvise(data, fSize, MADV_SEQUENTIAL);
+  fData = static_cast<const char*>(data);
+
+  fBinary = (fSize >= kHeaderSize &&
+             std::memcmp(fData, kBinaryMagic, 8) == 0);
+  if (fBinary) BuildBinaryIndex();
+  else         BuildTextIndex();
+
+  G4cout << "Primary file " << fileName << ": " << GetNumberOfEvents()
+         << " events (" << (fBinary ? "binary" : "text") << ")" << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+PrimaryFileReader::~PrimaryFileReader()
+{
+  if (fData) munmap(const_cast<char*>(fData), fSize);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PrimaryFileReader::BuildTextIndex()
+{
+  const char* end = fData + fSize;
+  const char* p   = fData;
+  G4int lineNo = 0;
+  fIndex.clear();
+
+  while (p < end) {
+    const char* eol = LineEnd(p, end);
+    ++lineNo;
+    if (IsEmptyLine(p, eol)) { p = eol + 1; continue; }
+
+    // event header: the number of particle lines that follow
+    fIndex.push_back(p - fData);
+    const char* q = p;
+    G4double count;
+    if (!NextNumber(q, eol, count) || count < 0.) {
+      G4ExceptionDescription ed;
+      ed << fFileName << ":" << lineNo << ": expected a particle count";
+      G4Exception("PrimaryFileReader::BuildTextIndex", "OpNovice2_016",
+                  FatalException, ed);
+      return;
+    }
+    p = eol + 1;
+    for (G4int n = (G4int)count; n > 0 && p < end; ) {
+      eol = LineEnd(p, end);
+      ++lineNo;
+      if (!IsEmptyLine(p, eol)) --n;
+      p = eol + 1;
+    }
+  }
+  fIndex.push_back(fSize);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PrimaryFileReader::BuildBinaryIndex()
+{
+  const uint32_t version    = ReadPOD<uint32_t>(fData + 8);
+  const uint32_t recordSize = ReadPOD<uint32_t>(fData + 12);
+  const size_t nRecords = (fSize - kHeaderSize) / kRecordSize;
+  if (version != kBinaryVersion || recordSize != kRecordSize ||
+      (fSize - kHeaderSize) % kRecordSize != 0) {
+    G4ExceptionDescription ed;
+    ed << "Binary primary file " << fFileName << " has version " << version
+       << " and record size " << recordSize << "; expected "
+       << kBinaryVersion << " and " << kRecordSize << " with whole records";
+    G4Exception("PrimaryFileReader::BuildBinaryIndex", "OpNovice2_016",
+                FatalException, ed);
+    return;
+  }
+
+  fIndex.clear();
+  const char* record = fData + kHeaderSize;
+  for (size_t i = 0; i < nRecords; ++i, record += kRecordSize) {
+    const int32_t event = ReadPOD<int32_t>(record);
+    if (i == 0 || event != ReadPOD<int32_t>(record - kRecordSize)) {
+      fIndex.push_back(i);
+    }
+  }
+  fIndex.push_back(nRecords);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int PrimaryFileReader::ReadText(G4int index,
+                                  std::vector<Particle>& particles) const
+{
+  const char* p   = fData + fIndex[index];
+  const char* end = fData + fIndex[index + 1];
+
+  const char* eol = LineEnd(p, end);
+  G4double count = 0.;
+  NextNumber(p, eol, count);
+  p = eol + 1;
+
+  while ((G4int)particles.size() < (G4int)count && p < end) {
+    eol = LineEnd(p, end);
+    if (!IsEmptyLine(p, eol)) {
+      G4double v[12];
+      G4int n = 0;
+      while (n < 12 && NextNumber(p, eol, v[n])) ++n;
+      if (n < 12) {
+        G4ExceptionDescription ed;
+        ed << "Event " << index << " in " << fFileName
+           << ": particle line with " << n << " of 12 values, skipped";
+        G4Exception("PrimaryFileReader::ReadText", "OpNovice2_017",
+                    JustWarning, ed);
+        --count;
+      }
+      else {
+        Particle part;
+        part.pdg = (G4int)v[0];
+        for (G4int k = 0; k < 3; ++k) {
+          part.pos[k] = v[1 + k]*mm;
+          part.mom[k] = v[4 + k]*MeV;
+          part.pol[k] = v[8 + k];
+        }
+        part.time   = v[7]*ns;
+        part.weight = v[11];
+        particles.push_back(part);
+      }
+    }
+    p = eol + 1;
+  }
+  return particles.size();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int PrimaryFileReader::ReadBinary(G4int index,
+                                    std::vector<Particle>& particles) const
+{
+  const char* record = fData + kHeaderSize + fIndex[index]*kRecordSize;
+  for (size_t i = fIndex[index]; i < fIndex[index + 1];
+       ++i, record += kRecordSize) {
+    const char* p = record + sizeof(int32_t);
+    Particle part;
+    part.pdg = ReadPOD<int32_t>(p);
+    p += sizeof(int32_t);
+    double v[11];
+    std::memcpy(v, p, sizeof(v));
+    for (G4int k = 0; k < 3; ++k) {
+      part.pos[k] = v[k]*mm;
+      part.mom[k] = v[3 + k]*MeV;
+      part.pol[k] = v[7 + k];
+    }
+    part.time   = v[6]*ns;
+    part.weight = v[10];
+    particles.push_back(part);
+  }
+  return particles.size();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool PrimaryFileReader::GenerateEvent(G4Event* anEvent, G4int index) const
+{
+  const G4int nEvents = GetNumberOfEvents();
+  if (index < 0 || index >= nEvents) {
+    if (!fExhausted.exchange(true)) {
+      G4ExceptionDescription ed;
+      ed << "Input event " << index << " requested, but " << fFileName
+         << " holds " << nEvents << " events. The run is stopped.";
+      G4Exception("PrimaryFileReader::GenerateEvent", "OpNovice2_027",
+                  JustWarning, ed);
+    }
+    return false;
+  }
+
+  std::vector<Particle> particles;
+  particles.reserve(fBinary ? fIndex[index + 1] - fIndex[index] : 16);
+  if (fBinary) ReadBinary(index, particles);
+  else         ReadText(index, particles);
+
+  G4ParticleTable* table = G4ParticleTable::GetParticleTable();
+  G4PrimaryVertex* vertex = nullptr;
+  const Particle*  previous = nullptr;
+
+  for (const Particle& part : particles) {
+    G4ParticleDefinition* def = (part.pdg == 0 || part.pdg == -22)
+      ? G4OpticalPhoton::Definition() : table->FindParticle(part.pdg);
+    if (!def) {
+      G4ExceptionDescription ed;
+      ed << "Event " << index << " in " << fFileName
+         << ": unknown PDG code " << part.pdg << ", particle skipped";
+      G4Exception("PrimaryFileReader::GenerateEvent", "OpNovice2_017",
+                  JustWarning, ed);
+      continue;
+    }
+
+    // particles from the same point and time share a vertex
+    if (!previous || std::memcmp(previous->pos, part.pos, sizeof(part.pos))
+                  || previous->time != part.time) {
+      vertex = new G4PrimaryVertex(
+        G4ThreeVector(part.pos[0], part.pos[1], part.pos[2]), part.time);
+      anEvent->AddPrimaryVertex(vertex);
+    }
+    previous = &part;
+
+    G4PrimaryParticle* primary =
+      new G4PrimaryParticle(def, part.mom[0], part.mom[1], part.mom[2]);
+    primary->SetPolarization(part.pol[0], part.pol[1], part.pol[2]);
+    primary->SetWeight(part.weight);
+    vertex->SetPrimary(primary);
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -33,25 +33,62 @@
 
 #include "PrimaryGeneratorAction.hh"
 #include "PrimaryGeneratorMessenger.hh"
+#include "PrimaryFileReader.hh"
+#include "CerenkovSource.hh"
+#include "DetectorConstruction.hh"
+#include "PhotonSampling.hh"
+#include "EventSeeder.hh"
 
 #include "Randomize.hh"
 
 #include "G4Event.hh"
+#include "G4Material.hh"
+#include "G4MaterialPropertiesTable.hh"
+#include "G4RunManager.hh"
+#include "G4Run.hh"
 #include "G4ParticleGun.hh"
 #include "G4ParticleTable.hh"
 #include "G4ParticleDefinition.hh"
+#include "G4PrimaryParticle.hh"
+#include "G4PrimaryVertex.hh"
+#include "G4OpticalPhoton.hh"
+#include "G4UIcommand.hh"
 #include "G4SystemOfUnits.hh"
+#include "G4PhysicalConstants.hh"
+
+#include <algorithm>
+#include <functional>
+#include <sstream>
+
+namespace {
+  // uniform numbers per photon: 3 position, 2 direction, 1 energy,
+  // 2 polarization
+  const G4int kRandomsPerPhoton = 8;
+}
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 PrimaryGeneratorAction::PrimaryGeneratorAction()
  : G4VUserPrimaryGeneratorAction(), 
-   fParticleGun(0)
+   fParticleGun(0),
+   fPhotonsPerEvent(0),
+   fPositionMode(kPoint),
+   fDirectionMode(kBeam),
+   fHalfSize(),
+   fConeAngle(0.),
+   fCerenkov(0),
+   fCerenkovRunID(-1),
+   fInput(nullptr),
+   fInputFirstEvent(0),
+   fPolarMode(kPolarGun),
+   fPolarAngle(0.),
+   fPolarDegree(1.)
 {
   G4int n_particle = 1;
   fParticleGun = new G4ParticleGun(n_particle);
 
   //create a messenger for this class
+  fCerenkov = new CerenkovSource();
   fGunMessenger = new PrimaryGeneratorMessenger(this);
 
   //default kinematic
@@ -72,45 +109,262 @@ PrimaryGeneratorAction::~PrimaryGeneratorAction()
 {
   delete fParticleGun;
   delete fGunMessenger;
+  delete fCerenkov;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 void PrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
 {
+  EventSeeder::Seed(anEvent);
+  if (fInput) {
+    if (!fInput->GenerateEvent(anEvent, fInputFirstEvent +
+                               EventSeeder::GetGlobalEventID(anEvent)))
+      G4RunManager::GetRunManager()->AbortRun(true);
+    return;
+  }
+  if (fCerenkov->GetBeta() > 0.) {
+    // the tables follow the tank material, which may change between runs
+    G4int runID = G4RunManager::GetRunManager()->GetCurrentRun()->GetRunID();
+    if (runID != fCerenkovRunID) {
+      const DetectorConstruction* det =
+        static_cast<const DetectorConstruction*>(
+          G4RunManager::GetRunManager()->GetUserDetectorConstruction());
+      G4MaterialPropertiesTable* mpt =
+        det->GetTankMaterial()->GetMaterialPropertiesTable();
+      fCerenkov->BuildTables(mpt ? mpt->GetProperty("RINDEX") : nullptr);
+      fCerenkovRunID = runID;
+    }
+    fCerenkov->Generate(anEvent, fParticleGun->GetParticlePosition(),
+                        fParticleGun->GetParticleMomentumDirection(),
+                        fParticleGun->GetParticleTime());
+    return;
+  }
+  if (fPhotonsPerEvent > 0) {
+    GeneratePhotons(anEvent);
+    return;
+  }
+
+  if (fPolarMode != kPolarGun &&
+      fParticleGun->GetParticleDefinition() == G4OpticalPhoton::Definition()) {
+    G4double u[2];
+    G4Random::getTheEngine()->flatArray(2, u);
+    fParticleGun->SetParticlePolarization(SamplePolarization(
+      fParticleGun->GetParticleMomentumDirection(), u[0], u[1]));
+  }
   fParticleGun->GeneratePrimaryVertex(anEvent);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+void PrimaryGeneratorAction::GeneratePhotons(G4Event* anEvent)
+{
+  const G4int n = fPhotonsPerEvent;
+  fRandom.resize(n*kRandomsPerPhoton);
+  G4Random::getTheEngine()->flatArray(n*kRandomsPerPhoton, fRandom.data());
+
+  const G4ThreeVector centre = fParticleGun->GetParticlePosition();
+  const G4ThreeVector axis   = fParticleGun->GetParticleMomentumDirection();
+  const G4double      time   = fParticleGun->GetParticleTime();
+  const G4double      energy = fParticleGun->GetParticleEnergy();
+  const G4double cosMin = (fDirectionMode == kIsotropic) ? -1.
+                                                        : std::cos(fConeAngle);
+  G4ParticleDefinition* photon = G4OpticalPhoton::Definition();
+
+  // face areas of the source box, for the surface mode
+  const G4double hx = fHalfSize.x(), hy = fHalfSize.y(), hz = fHalfSize.z();
+  const G4double axy = hx*hy, ayz = hy*hz, axz = hx*hz;
+  const G4double area = axy + ayz + axz;
+
+  // a point source shares one vertex
+  G4PrimaryVertex* vertex = nullptr;
+  if (fPositionMode == kPoint) {
+    vertex = new G4PrimaryVertex(centre, time);
+    anEvent->AddPrimaryVertex(vertex);
+  }
+
+  for (G4int i = 0; i < n; ++i) {
+    const G4double* u = &fRandom[i*kRandomsPerPhoton];
+
+    if (fPositionMode != kPoint) {
+      G4ThreeVector pos;
+      if (fPositionMode == kBox) {
+        pos.set((2.*u[0] - 1.)*hx, (2.*u[1] - 1.)*hy, (2.*u[2] - 1.)*hz);
+      }
+      else {
+        // pick a face pair by area, then the side from the same number
+        G4double a = 2.*u[0]*area;
+        const G4double side = (a < area) ? -1. : 1.;
+        if (a >= area) a -= area;
+        if (a < axy) {
+          pos.set((2.*u[1] - 1.)*hx, (2.*u[2] - 1.)*hy, side*hz);
+        }
+        else if (a < axy + ayz) {
+          pos.set(side*hx, (2.*u[1] - 1.)*hy, (2.*u[2] - 1.)*hz);
+        }
+        else {
+          pos.set((2.*u[1] - 1.)*hx, side*hy, (2.*u[2] - 1.)*hz);
+        }
+      }
+      vertex = new G4PrimaryVertex(centre + pos, time);
+      anEvent->AddPrimaryVertex(vertex);
+    }
+
+    G4ThreeVector dir = (fDirectionMode == kBeam)
+      ? axis : PhotonSampling::Cone(axis, cosMin, u[3], u[4]);
+
+    G4PrimaryParticle* particle = new G4PrimaryParticle(photon);
+    particle->SetMomentumDirection(dir);
+    particle->SetKineticEnergy(fSpectrumCdf.empty() ? energy
+                                                    : SampleEnergy(u[5]));
+    particle->SetPolarization(SamplePolarization(dir, u[6], u[7]));
+    vertex->SetPrimary(particle);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double PrimaryGeneratorAction::SampleEnergy(G4double u) const
+{
+  // bin by binary search in the cumulative, then invert the linear
+  // density within the bin
+  const G4double target = u*fSpectrumCdf.back();
+  size_t bin = std::upper_bound(fSpectrumCdf.begin(), fSpectrumCdf.end(),
+                                target) - fSpectrumCdf.begin();
+  bin = std::min(std::max(bin, size_t(1)), fSpectrumCdf.size() - 1) - 1;
+
+  const G4double e0 = fSpectrumEnergy[bin], e1 = fSpectrumEnergy[bin+1];
+  const G4double w0 = fSpectrumWeight[bin], w1 = fSpectrumWeight[bin+1];
+  const G4double area = target - fSpectrumCdf[bin];
+  const G4double width = e1 - e0;
+  // solve w0*t + (w1-w0)/2*t^2 = area/width for t in [0,1], in the form
+  // that stays stable for a flat bin
+  const G4double c = area/width;
+  const G4double d = w0 + std::sqrt(std::max(w0*w0 + 2.*(w1 - w0)*c, 0.));
+  const G4double t = (d > 0.) ? 2.*c/d : 0.;
+  return e0 + std::min(std::max(t, 0.), 1.)*width;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PrimaryGeneratorAction::SetPhotonsPerEvent(G4int n)
+{
+  fPhotonsPerEvent = std::max(n, 0);
+  // the run summary and tracking take the primary from the gun
+  if (fPhotonsPerEvent > 0) {
+    fParticleGun->SetParticleDefinition(G4OpticalPhoton::Definition());
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PrimaryGeneratorAction::SetCerenkovBeta(G4double beta)
+{
+  fCerenkov->SetBeta(beta);
+  fCerenkovRunID = -1;
+  if (beta > 0.) {
+    fParticleGun->SetParticleDefinition(G4OpticalPhoton::Definition());
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PrimaryGeneratorAction::SetInputFile(const G4String& fileName)
+{
+  // the reader is shared by all threads and lives until the end of the job
+  fInput = fileName.empty() ? nullptr : PrimaryFileReader::Open(fileName);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PrimaryGeneratorAction::SetSpectrum(const G4String& spec)
+{
+  fSpectrumEnergy.clear();
+  fSpectrumWeight.clear();
+  fSpectrumCdf.clear();
+
+  std::istringstream is(spec);
+  G4String unit;
+  if (!(is >> unit)) return;
+  const G4double scale = G4UIcommand::ValueOf(unit);
+  G4double e, w;
+  while (is >> e >> w) {
+    fSpectrumEnergy.push_back(e*scale);
+    fSpectrumWeight.push_back(std::max(w, 0.));
+  }
+
+  // strictly increasing: a repeated energy makes a bin of zero width
+  if (fSpectrumEnergy.size() < 2 || scale <= 0. ||
+      std::adjacent_find(fSpectrumEnergy.begin(), fSpectrumEnergy.end(),
+                         std::greater_equal<G4double>())
+        != fSpectrumEnergy.end()) {
+    G4ExceptionDescription ed;
+    ed << "Spectrum needs a unit and at least two (energy, weight) pairs "
+       << "with strictly increasing energy: " << spec;
+    G4Exception("PrimaryGeneratorAction::SetSpectrum", "OpNovice2_015",
+                JustWarning, ed);
+    fSpectrumEnergy.clear();
+    fSpectrumWeight.clear();
+    return;
+  }
+
+  // trapezoid integral of the weights
+  fSpectrumCdf.assign(1, 0.);
+  for (size_t i = 1; i < fSpectrumEnergy.size(); ++i) {
+    fSpectrumCdf.push_back(fSpectrumCdf.back() +
+      0.5*(fSpectrumWeight[i-1] + fSpectrumWeight[i])
+         *(fSpectrumEnergy[i] - fSpectrumEnergy[i-1]));
+  }
+  if (fSpectrumCdf.back() <= 0.) fSpectrumCdf.clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
 void PrimaryGeneratorAction::SetOptPhotonPolar()
 {
- G4double angle = G4UniformRand() * 360.0*deg;
- SetOptPhotonPolar(angle);
+  SetPolarizationMode(kPolarRandom);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 void PrimaryGeneratorAction::SetOptPhotonPolar(G4double angle)
 {
- if (fParticleGun->GetParticleDefinition()->GetParticleName()!="opticalphoton")
+  fPolarAngle = angle;
+  SetPolarizationMode(kPolarFixed);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PrimaryGeneratorAction::SetPolarizationMode(PolarizationMode mode)
+{
+  if (fPhotonsPerEvent == 0 &&
+      fParticleGun->GetParticleDefinition()->GetParticleName()!="opticalphoton")
    {
-     G4cout << "--> warning from PrimaryGeneratorAction::SetOptPhotonPolar() :"
+     G4cout << "--> warning from PrimaryGeneratorAction::SetPolarizationMode() :"
                "the particleGun is not an opticalphoton" << G4endl;
-     return;
    }
+  fPolarMode = mode;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4ThreeVector PrimaryGeneratorAction::SamplePolarization(
+                     const G4ThreeVector& kphoton, G4double u1, G4double u2) const
+{
+  G4bool fixed = (fPolarMode == kPolarFixed) ||
+                 (fPolarMode == kPolarPartial && u2 < fPolarDegree);
+  if (!fixed) return PhotonSampling::Polarization(kphoton, twopi*u1);
+
+  // the angle is measured from the (k, x) plane, as it always was
+  G4ThreeVector normal (1., 0., 0.);
+  G4ThreeVector product = normal.cross(kphoton);
+  G4double modul2       = product*product;
+
+  G4ThreeVector e_perpend (0., 0., 1.);
+  if (modul2 > 0.) e_perpend = (1./std::sqrt(modul2))*product;
+  G4ThreeVector e_paralle    = e_perpend.cross(kphoton);
 
- G4ThreeVector normal (1., 0., 0.);
- G4ThreeVector kphoton = fParticleGun->GetParticleMomentumDirection();
- G4ThreeVector product = normal.cross(kphoton);
- G4double modul2       = product*product;
- 
- G4ThreeVector e_perpend (0., 0., 1.);
- if (modul2 > 0.) e_perpend = (1./std::sqrt(modul2))*product;
- G4ThreeVector e_paralle    = e_perpend.cross(kphoton);
- 
- G4ThreeVector polar = std::cos(angle)*e_paralle + std::sin(angle)*e_perpend;
- fParticleGun->SetParticlePolarization(polar);
+  return std::cos(fPolarAngle)*e_paralle + std::sin(fPolarAngle)*e_perpend;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -33,8 +33,15 @@
 #include "PrimaryGeneratorMessenger.hh"
 
 #include "PrimaryGeneratorAction.hh"
+#include "CerenkovSource.hh"
 #include "G4UIdirectory.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4UIcmdWithADouble.hh"
 #include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWith3VectorAndUnit.hh"
 #include "G4SystemOfUnits.hh"
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -50,12 +57,122 @@ PrimaryGeneratorMessenger::
   fPolarCmd =
            new G4UIcmdWithADoubleAndUnit("/opnovice2/gun/optPhotonPolar",this);
   fPolarCmd->SetGuidance("Set linear polarization");
-  fPolarCmd->SetGuidance("  angle w.r.t. (k,n) plane");
+  fPolarCmd->SetGuidance("  angle w.r.t. (k,n) plane;");
+  fPolarCmd->SetGuidance("  no angle: random for every photon.");
   fPolarCmd->SetParameterName("angle",true);
   fPolarCmd->SetUnitCategory("Angle");
   fPolarCmd->SetDefaultValue(-360.0);
   fPolarCmd->SetDefaultUnit("deg");
   fPolarCmd->AvailableForStates(G4State_Idle);
+
+  fPolarModeCmd = new G4UIcmdWithAString("/opnovice2/gun/polarization",this);
+  fPolarModeCmd->SetGuidance("Optical-photon polarization, sampled per photon:");
+  fPolarModeCmd->SetGuidance("  fixed   - at the optPhotonPolar angle");
+  fPolarModeCmd->SetGuidance("  random  - uniform angle");
+  fPolarModeCmd->SetGuidance("  partial - fixed with probability");
+  fPolarModeCmd->SetGuidance("            polarizationDegree, else random");
+  fPolarModeCmd->SetParameterName("mode",false);
+  fPolarModeCmd->SetCandidates("fixed random partial");
+  fPolarModeCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fPolarDegreeCmd =
+           new G4UIcmdWithADouble("/opnovice2/gun/polarizationDegree",this);
+  fPolarDegreeCmd->SetGuidance("Degree of linear polarization, partial mode.");
+  fPolarDegreeCmd->SetParameterName("degree",false);
+  fPolarDegreeCmd->SetRange("degree>=0. && degree<=1.");
+  fPolarDegreeCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fPhotonsCmd =
+           new G4UIcmdWithAnInteger("/opnovice2/gun/photonsPerEvent",this);
+  fPhotonsCmd->SetGuidance("Number of optical photons per event.");
+  fPhotonsCmd->SetGuidance("  0 shoots the /gun particle instead.");
+  fPhotonsCmd->SetParameterName("n",false);
+  fPhotonsCmd->SetRange("n>=0");
+  fPhotonsCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fPositionCmd = new G4UIcmdWithAString("/opnovice2/gun/position",this);
+  fPositionCmd->SetGuidance("Photon vertex distribution around /gun/position:");
+  fPositionCmd->SetGuidance("  point, box (volume) or surface (box faces).");
+  fPositionCmd->SetParameterName("mode",false);
+  fPositionCmd->SetCandidates("point box surface");
+  fPositionCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fHalfSizeCmd =
+           new G4UIcmdWith3VectorAndUnit("/opnovice2/gun/halfSize",this);
+  fHalfSizeCmd->SetGuidance("Half lengths of the box source.");
+  fHalfSizeCmd->SetParameterName("hx","hy","hz",false);
+  fHalfSizeCmd->SetUnitCategory("Length");
+  fHalfSizeCmd->SetDefaultUnit("mm");
+  fHalfSizeCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fAngularCmd = new G4UIcmdWithAString("/opnovice2/gun/angular",this);
+  fAngularCmd->SetGuidance("Photon direction distribution:");
+  fAngularCmd->SetGuidance("  beam (along /gun/direction), isotropic or");
+  fAngularCmd->SetGuidance("  cone (uniform within coneAngle of /gun/direction).");
+  fAngularCmd->SetParameterName("mode",false);
+  fAngularCmd->SetCandidates("beam isotropic cone");
+  fAngularCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fConeAngleCmd =
+           new G4UIcmdWithADoubleAndUnit("/opnovice2/gun/coneAngle",this);
+  fConeAngleCmd->SetGuidance("Half opening angle of the cone source.");
+  fConeAngleCmd->SetParameterName("angle",false);
+  fConeAngleCmd->SetRange("angle>=0.");
+  fConeAngleCmd->SetUnitCategory("Angle");
+  fConeAngleCmd->SetDefaultUnit("deg");
+  fConeAngleCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fSpectrumCmd = new G4UIcommand("/opnovice2/gun/spectrum",this);
+  fSpectrumCmd->SetGuidance("Photon energy spectrum: unit E1 w1 E2 w2 ...");
+  fSpectrumCmd->SetGuidance("  weights are interpolated linearly in energy.");
+  fSpectrumCmd->SetGuidance("  No argument reverts to /gun/energy.");
+  G4UIparameter* param = new G4UIparameter("spectrum",'s',true);
+  param->SetDefaultValue("");
+  fSpectrumCmd->SetParameter(param);
+  fSpectrumCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fCerenkovBetaCmd =
+           new G4UIcmdWithADouble("/opnovice2/gun/cerenkovBeta",this);
+  fCerenkovBetaCmd->SetGuidance("Emit the Cerenkov photons of a unit-charge");
+  fCerenkovBetaCmd->SetGuidance("  particle with this speed instead of");
+  fCerenkovBetaCmd->SetGuidance("  tracking it; 0 switches the source off.");
+  fCerenkovBetaCmd->SetParameterName("beta",false);
+  fCerenkovBetaCmd->SetRange("beta>=0. && beta<1.");
+  fCerenkovBetaCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fCerenkovSegmentCmd =
+           new G4UIcmdWithADoubleAndUnit("/opnovice2/gun/cerenkovSegment",this);
+  fCerenkovSegmentCmd->SetGuidance("Track length along /gun/direction over");
+  fCerenkovSegmentCmd->SetGuidance("  which the Cerenkov photons are emitted.");
+  fCerenkovSegmentCmd->SetParameterName("length",false);
+  fCerenkovSegmentCmd->SetRange("length>0.");
+  fCerenkovSegmentCmd->SetUnitCategory("Length");
+  fCerenkovSegmentCmd->SetDefaultUnit("mm");
+  fCerenkovSegmentCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fCerenkovPhotonsCmd =
+           new G4UIcmdWithAnInteger("/opnovice2/gun/cerenkovPhotons",this);
+  fCerenkovPhotonsCmd->SetGuidance("Cerenkov photons per event; 0 draws the");
+  fCerenkovPhotonsCmd->SetGuidance("  number from the Frank-Tamm mean.");
+  fCerenkovPhotonsCmd->SetParameterName("n",false);
+  fCerenkovPhotonsCmd->SetRange("n>=0");
+  fCerenkovPhotonsCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fInputFileCmd = new G4UIcommand("/opnovice2/gun/inputFile",this);
+  fInputFileCmd->SetGuidance("Read the primaries from a text or binary file");
+  fInputFileCmd->SetGuidance("  (format in PrimaryFileReader.hh).");
+  fInputFileCmd->SetGuidance("  No argument returns to the gun.");
+  param = new G4UIparameter("fileName",'s',true);
+  param->SetDefaultValue("");
+  fInputFileCmd->SetParameter(param);
+  fInputFileCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fInputFirstCmd =
+           new G4UIcmdWithAnInteger("/opnovice2/gun/inputFirstEvent",this);
+  fInputFirstCmd->SetGuidance("Input event used for the first event of a run.");
+  fInputFirstCmd->SetParameterName("first",false);
+  fInputFirstCmd->SetRange("first>=0");
+  fInputFirstCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -63,6 +180,19 @@ PrimaryGeneratorMessenger::
 PrimaryGeneratorMessenger::~PrimaryGeneratorMessenger()
 {
   delete fPolarCmd;
+  delete fPolarModeCmd;
+  delete fPolarDegreeCmd;
+  delete fPhotonsCmd;
+  delete fPositionCmd;
+  delete fHalfSizeCmd;
+  delete fAngularCmd;
+  delete fConeAngleCmd;
+  delete fSpectrumCmd;
+  delete fCerenkovBetaCmd;
+  delete fCerenkovSegmentCmd;
+  delete fCerenkovPhotonsCmd;
+  delete fInputFileCmd;
+  delete fInputFirstCmd;
   delete fGunDir;
 }
 
@@ -79,6 +209,58 @@ void PrimaryGeneratorMessenger::SetNewValue(
          fPrimaryAction->SetOptPhotonPolar(angle);
       }
   }
+  else if (command == fPolarModeCmd) {
+    fPrimaryAction->SetPolarizationMode(
+      newValue == "fixed"   ? PrimaryGeneratorAction::kPolarFixed :
+      newValue == "partial" ? PrimaryGeneratorAction::kPolarPartial
+                            : PrimaryGeneratorAction::kPolarRandom);
+  }
+  else if (command == fPolarDegreeCmd) {
+    fPrimaryAction->SetPolarizationDegree(
+      fPolarDegreeCmd->GetNewDoubleValue(newValue));
+  }
+  else if (command == fPhotonsCmd) {
+    fPrimaryAction->SetPhotonsPerEvent(fPhotonsCmd->GetNewIntValue(newValue));
+  }
+  else if (command == fPositionCmd) {
+    fPrimaryAction->SetPositionMode(
+      newValue == "box"     ? PrimaryGeneratorAction::kBox :
+      newValue == "surface" ? PrimaryGeneratorAction::kSurface
+                            : PrimaryGeneratorAction::kPoint);
+  }
+  else if (command == fHalfSizeCmd) {
+    fPrimaryAction->SetSourceHalfSize(
+      fHalfSizeCmd->GetNew3VectorValue(newValue));
+  }
+  else if (command == fAngularCmd) {
+    fPrimaryAction->SetDirectionMode(
+      newValue == "isotropic" ? PrimaryGeneratorAction::kIsotropic :
+      newValue == "cone"      ? PrimaryGeneratorAction::kCone
+                              : PrimaryGeneratorAction::kBeam);
+  }
+  else if (command == fConeAngleCmd) {
+    fPrimaryAction->SetConeAngle(fConeAngleCmd->GetNewDoubleValue(newValue));
+  }
+  else if (command == fSpectrumCmd) {
+    fPrimaryAction->SetSpectrum(newValue);
+  }
+  else if (command == fCerenkovBetaCmd) {
+    fPrimaryAction->SetCerenkovBeta(fCerenkovBetaCmd->GetNewDoubleValue(newValue));
+  }
+  else if (command == fCerenkovSegmentCmd) {
+    fPrimaryAction->GetCerenkovSource()->SetSegmentLength(
+      fCerenkovSegmentCmd->GetNewDoubleValue(newValue));
+  }
+  else if (command == fCerenkovPhotonsCmd) {
+    fPrimaryAction->GetCerenkovSource()->SetNumberOfPhotons(
+      fCerenkovPhotonsCmd->GetNewIntValue(newValue));
+  }
+  else if (command == fInputFileCmd) {
+    fPrimaryAction->SetInputFile(newValue);
+  }
+  else if (command == fInputFirstCmd) {
+    fPrimaryAction->SetInputFirstEvent(fInputFirstCmd->GetNewIntValue(newValue));
+  }
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
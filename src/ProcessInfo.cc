@@ -0,0 +1,99 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/src/ProcessInfo.cc
+/// \brief Implementation of the ProcessInfo class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "ProcessInfo.hh"
+
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <sys/resource.h>
+
+namespace {
+  std::chrono::steady_clock::time_point gStartTime =
+    std::chrono::steady_clock::now();
+
+  // value of a "Key:   1234 kB" line of /proc/self/status, in MB;
+  // -1 where /proc is not available
+  G4double ReadStatusField(const char* key)
+  {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    const std::string prefix = std::string(key) + ":";
+    while (std::getline(status, line)) {
+      if (line.compare(0, prefix.size(), prefix) == 0) {
+        return std::stod(line.substr(prefix.size())) / 1024.;
+      }
+    }
+    return -1.;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ProcessInfo::Start()
+{
+  gStartTime = std::chrono::steady_clock::now();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double ProcessInfo::GetElapsedTime()
+{
+  std::chrono::duration<G4double> elapsed =
+    std::chrono::steady_clock::now() - gStartTime;
+  return elapsed.count();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double ProcessInfo::GetResidentMemory()
+{
+  return ReadStatusField("VmRSS");
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double ProcessInfo::GetPeakResidentMemory()
+{
+  G4double peak = ReadStatusField("VmHWM");
+  if (peak >= 0.) return peak;
+
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) return -1.;
+#ifdef __APPLE__
+  return usage.ru_maxrss / (1024. * 1024.);  // bytes
+#else
+  return usage.ru_maxrss / 1024.;            // kB
+#endif
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,332 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/src/ProgressMonitor.cc
+/// \brief Implementation of the ProgressMonitor class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "ProgressMonitor.hh"
+
+#include "G4Threading.hh"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+namespace {
+  // one cache line per thread, written by that thread alone; slot 0 is
+  // the sequential run manager (thread ID -1)
+  const G4int kSlots = 512;
+
+  struct alignas(64) Slot {
+    std::atomic<G4long> events;
+    std::atomic<G4long> steps;
+    std::atomic<G4long> photons;
+  };
+
+  Slot slots[kSlots];
+  std::atomic<bool> running(false);
+
+  G4double interval = 0.;
+  G4String statusFile;
+
+  std::thread             monitor;
+  std::mutex              mutex;
+  std::condition_variable wakeup;
+  bool                    stopRequested = false;
+
+  struct Totals {
+    G4long   events;
+    G4long   steps;
+    G4long   photons;
+    G4double bytes;
+  };
+
+  //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+  Totals Sum()
+  {
+    Totals sum = {0, 0, 0, 0.};
+    for (G4int i = 0; i < kSlots; ++i) {
+      sum.events  += slots[i].events.load(std::memory_order_relaxed);
+      sum.steps   += slots[i].steps.load(std::memory_order_relaxed);
+      sum.photons += slots[i].photons.load(std::memory_order_relaxed);
+    }
+    return sum;
+  }
+
+  //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+  // <base>.root, or <base>_t<N>.root written by worker N; other files
+  // sharing the prefix (summaries, digests, spectra) are not output
+  G4bool IsOutputFile(const std::string& name, const std::string& base)
+  {
+    const std::string ext = ".root";
+    if (name.size() < base.size() + ext.size() ||
+        name.compare(0, base.size(), base) != 0 ||
+        name.compare(name.size() - ext.size(), ext.size(), ext) != 0) {
+      return false;
+    }
+    std::string middle = name.substr(base.size(),
+                                     name.size() - base.size() - ext.size());
+    if (middle.empty()) return true;
+    if (middle.size() < 3 || middle.compare(0, 2, "_t") != 0) return false;
+    return middle.find_first_not_of("0123456789", 2) == std::string::npos;
+  }
+
+  // size of the analysis files written so far
+  G4double OutputBytes(const G4String& base)
+  {
+    G4double bytes = 0.;
+#if defined(__unix__) || defined(__APPLE__)
+    if (base.empty()) return bytes;
+    std::string dir = ".";
+    std::string prefix = base;
+    std::string::size_type slash = base.rfind('/');
+    if (slash != std::string::npos) {
+      dir = slash ? base.substr(0, slash) : "/";
+      prefix = base.substr(slash + 1);
+    }
+    if (prefix.size() > 5 &&
+        prefix.compare(prefix.size() - 5, 5, ".root") == 0) {
+      prefix.erase(prefix.size() - 5);
+    }
+    DIR* d = opendir(dir.c_str());
+    if (!d) return bytes;
+    while (dirent* entry = readdir(d)) {
+      std::string name = entry->d_name;
+      if (!IsOutputFile(name, prefix)) continue;
+      struct stat info;
+      if (stat((dir + "/" + name).c_str(), &info) == 0 &&
+          S_ISREG(info.st_mode)) {
+        bytes += info.st_size;
+      }
+    }
+    closedir(d);
+#else
+    (void)base;
+#endif
+    return bytes;
+  }
+
+  //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+  std::string FormatTime(G4double seconds)
+  {
+    if (seconds < 0.) return "--";
+    long s = static_cast<long>(seconds + 0.5);
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%ld:%02ld:%02ld",
+                  s/3600, (s/60)%60, s%60);
+    return buffer;
+  }
+
+  //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+  struct Status {
+    G4int    runID;
+    G4int    toProcess;
+    G4String outputBase;
+    std::chrono::steady_clock::time_point start;
+    std::chrono::steady_clock::time_point last;
+    Totals   lastTotals;
+  };
+
+  Status status;
+
+  //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+  void Report(G4bool finished)
+  {
+    std::chrono::steady_clock::time_point now =
+      std::chrono::steady_clock::now();
+    G4double elapsed =
+      std::chrono::duration<G4double>(now - status.start).count();
+    G4double dt = std::chrono::duration<G4double>(now - status.last).count();
+    if (dt <= 0.) dt = 1.e-9;
+
+    Totals total = Sum();
+    total.bytes = OutputBytes(status.outputBase);
+    const Totals& last = status.lastTotals;
+
+    G4double eventRate  = (total.events - last.events)/dt;
+    G4double stepRate   = (total.steps - last.steps)/dt;
+    G4double photonRate = (total.photons - last.photons)/dt;
+    G4double outputRate = (total.bytes - last.bytes)/dt/1.e6;
+
+    // the ETA uses the mean rate of the run, the last interval is noisy
+    G4double eta = -1.;
+    if (finished) eta = 0.;
+    else if (total.events > 0 && status.toProcess > 0) {
+      eta = (status.toProcess - total.events)*elapsed/total.events;
+    }
+    status.last = now;
+    status.lastTotals = total;
+
+    // G4cout is thread-local and not set up for this thread
+    if (!finished) {
+      std::ostringstream line;
+      line << std::fixed << std::setprecision(1)
+           << "Progress: run " << status.runID << ", " << total.events;
+      if (status.toProcess > 0) {
+        line << "/" << status.toProcess << " events ("
+             << 100.*total.events/status.toProcess << "%)";
+      }
+      else line << " events";
+      line << ", " << eventRate << " events/s, "
+           << std::scientific << std::setprecision(3)
+           << stepRate << " steps/s, " << photonRate << " photons/s, "
+           << std::fixed << std::setprecision(2)
+           << outputRate << " MB/s output, ETA " << FormatTime(eta) << "\n";
+      std::cout << line.str() << std::flush;
+    }
+
+    if (statusFile.empty()) return;
+    std::string temp = statusFile + ".tmp";
+    {
+      std::ofstream out(temp.c_str());
+      out << "{\n"
+          << "  \"run\": " << status.runID << ",\n"
+          << "  \"state\": \"" << (finished ? "finished" : "running")
+          << "\",\n"
+          << "  \"events\": " << total.events << ",\n"
+          << "  \"events_to_process\": " << status.toProcess << ",\n"
+          << "  \"steps\": " << total.steps << ",\n"
+          << "  \"photons\": " << total.photons << ",\n"
+          << "  \"output_bytes\": " << total.bytes << ",\n"
+          << "  \"elapsed_s\": " << elapsed << ",\n"
+          << "  \"events_per_s\": " << eventRate << ",\n"
+          << "  \"steps_per_s\": " << stepRate << ",\n"
+          << "  \"photons_per_s\": " << photonRate << ",\n"
+          << "  \"output_MB_per_s\": " << outputRate << ",\n"
+          << "  \"eta_s\": " << eta << ",\n"
+          << "  \"time\": " << std::time(nullptr) << "\n"
+          << "}\n";
+      out.close();
+      if (!out) {
+        std::remove(temp.c_str());
+        return;
+      }
+    }
+    // readers see either the old or the new file, never a partial one
+    if (std::rename(temp.c_str(), statusFile.c_str()) != 0) {
+      std::remove(temp.c_str());
+    }
+  }
+
+  //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+  void Loop()
+  {
+    std::chrono::duration<G4double> period(interval);
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!stopRequested) {
+      wakeup.wait_for(lock, period, []{return stopRequested;});
+      if (stopRequested) break;
+      lock.unlock();
+      Report(false);
+      lock.lock();
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ProgressMonitor::SetInterval(G4double seconds) {interval = seconds;}
+
+void ProgressMonitor::SetStatusFile(const G4String& name) {statusFile = name;}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ProgressMonitor::Start(G4int runID, G4int eventsToProcess,
+                            const G4String& outputBase)
+{
+  Stop();
+  if (interval <= 0.) return;
+
+  for (G4int i = 0; i < kSlots; ++i) {
+    slots[i].events.store(0, std::memory_order_relaxed);
+    slots[i].steps.store(0, std::memory_order_relaxed);
+    slots[i].photons.store(0, std::memory_order_relaxed);
+  }
+  status.runID      = runID;
+  status.toProcess  = eventsToProcess;
+  status.outputBase = outputBase;
+  status.start      = std::chrono::steady_clock::now();
+  status.last       = status.start;
+  status.lastTotals = Totals();
+  status.lastTotals.bytes = OutputBytes(outputBase);
+
+  stopRequested = false;
+  running = true;
+  monitor = std::thread(Loop);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ProgressMonitor::Stop()
+{
+  if (!monitor.joinable()) return;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopRequested = true;
+  }
+  wakeup.notify_all();
+  monitor.join();
+  running = false;
+  Report(true);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ProgressMonitor::Publish(G4long events, G4long steps, G4long photons)
+{
+  if (!running.load(std::memory_order_relaxed)) return;
+  G4int index = G4Threading::G4GetThreadId() + 1;
+  if (index < 0 || index >= kSlots) return;
+  // single writer per slot: plain stores, no read-modify-write
+  Slot& slot = slots[index];
+  slot.events.store(events, std::memory_order_relaxed);
+  slot.steps.store(steps, std::memory_order_relaxed);
+  slot.photons.store(photons, std::memory_order_relaxed);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
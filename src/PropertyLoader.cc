@@ -0,0 +1,362 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/src/PropertyLoader.cc
+/// \brief Implementation of the PropertyLoader class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "PropertyLoader.hh"
+#include "DetectorConstruction.hh"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+
+#include "G4MaterialPropertyVector.hh"
+#include "G4UIcommand.hh"
+
+namespace {
+  const char     kBinaryMagic[8] = {'O','P','N','2','P','R','O','P'};
+  const uint32_t kBinaryVersion  = 1;
+
+  inline G4bool IsBlank(char c)
+  { return c == ' ' || c == '\t' || c == '\r'; }
+
+  // split [begin, end) on blanks; stops at a '#' comment
+  void Tokenize(const char* begin, const char* end,
+                std::vector<G4String>& tokens)
+  {
+    tokens.clear();
+    const char* p = begin;
+    while (p < end) {
+      while (p < end && IsBlank(*p)) ++p;
+      if (p == end || *p == '#') break;
+      const char* q = p;
+      while (q < end && !IsBlank(*q) && *q != '#') ++q;
+      tokens.push_back(G4String(p, q - p));
+      p = q;
+    }
+  }
+
+  // property name with an optional ":unit" suffix
+  G4double SplitUnit(G4String& name)
+  {
+    size_t colon = name.find(':');
+    if (colon == std::string::npos) return 1.;
+    G4double scale = G4UIcommand::ValueOf(name.substr(colon + 1).c_str());
+    name = name.substr(0, colon);
+    return scale;
+  }
+
+  template <class T>
+  G4bool ReadPOD(const char*& p, const char* end, T& value)
+  {
+    if (end - p < (long)sizeof(T)) return false;
+    std::memcpy(&value, p, sizeof(T));
+    p += sizeof(T);
+    return true;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+PropertyLoader::PropertyLoader(DetectorConstruction* det)
+  : fDetector(det)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+PropertyLoader::~PropertyLoader()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int PropertyLoader::Load(const G4String& fileName)
+{
+  fFileName = fileName;
+
+  // slurp the whole file; the parsers then make a single pass over memory
+  std::ifstream in(fileName, std::ios::binary | std::ios::ate);
+  if (!in) {
+    G4ExceptionDescription ed;
+    ed << "Cannot open property file " << fileName;
+    G4Exception("PropertyLoader::Load", "OpNovice2_004", FatalException, ed);
+    return 0;
+  }
+  std::streamsize size = in.tellg();
+  in.seekg(0, std::ios::beg);
+  std::vector<char> buffer(size + 1, '\0');
+  in.read(buffer.data(), size);
+
+  const char* begin = buffer.data();
+  const char* end   = begin + size;
+
+  G4int n = 0;
+  if (size >= 8 && std::memcmp(begin, kBinaryMagic, 8) == 0) {
+    n = ParseBinary(begin + 8, end);
+  } else {
+    n = ParseText(begin, end);
+  }
+  G4cout << "Loaded " << n << " material properties from " << fileName
+         << G4endl;
+  return n;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int PropertyLoader::ParseText(const char* begin, const char* end)
+{
+  G4int nLoaded = 0;
+  G4int lineNo  = 0;
+
+  // state of the table currently being read
+  G4bool inTable = false;
+  Target target  = kNoTarget;
+  G4double energyUnit = 1.;
+  std::vector<G4String> names;
+  std::vector<G4double> scales;
+  std::vector<G4double> energies;
+  std::vector<std::vector<G4double> > columns;
+
+  std::vector<G4String> tokens;
+
+  auto flush = [&]() {
+    for (size_t i = 0; i < names.size(); ++i) {
+      std::vector<G4double> e(energies);
+      AddVector(target, names[i], e, columns[i]);
+      ++nLoaded;
+    }
+    inTable = false;
+    names.clear();
+    scales.clear();
+    energies.clear();
+    columns.clear();
+  };
+
+  auto fail = [&](const char* what) {
+    G4ExceptionDescription ed;
+    ed << fFileName << ":" << lineNo << ": " << what;
+    G4Exception("PropertyLoader::ParseText", "OpNovice2_005",
+                FatalException, ed);
+  };
+
+  const char* line = begin;
+  while (line < end) {
+    const char* eol = static_cast<const char*>(
+      std::memchr(line, '\n', end - line));
+    if (!eol) eol = end;
+    ++lineNo;
+
+    const char* p = line;
+    while (p < eol && IsBlank(*p)) ++p;
+
+    if (p == eol || *p == '#') {
+      // blank line or comment
+    }
+    else if (inTable && (std::isdigit((unsigned char)*p) || *p == '.' ||
+                         *p == '-' || *p == '+')) {
+      // data row: energy followed by one value per column
+      char* next = nullptr;
+      G4double en = std::strtod(p, &next);
+      if (next == p || next > eol) { fail("bad energy value"); return nLoaded; }
+      energies.push_back(en * energyUnit);
+      for (size_t i = 0; i < columns.size(); ++i) {
+        const char* q = next;
+        G4double val = std::strtod(q, &next);
+        if (next == q || next > eol) {
+          fail("too few values in row");
+          return nLoaded;
+        }
+        columns[i].push_back(val * scales[i]);
+      }
+    }
+    else {
+      Tokenize(p, eol, tokens);
+      if (inTable) flush();
+
+      if (tokens[0] == "end") {
+        // explicit end of table, already flushed
+      }
+      else if (tokens[0] == "table") {
+        if (tokens.size() < 4) {
+          fail("table needs a target, an energy unit and property names");
+          return nLoaded;
+        }
+        target = GetTarget(tokens[1]);
+        if (target == kNoTarget) { fail("unknown target"); return nLoaded; }
+        energyUnit = G4UIcommand::ValueOf(tokens[2]);
+        for (size_t i = 3; i < tokens.size(); ++i) {
+          G4String name = tokens[i];
+          scales.resize(names.size() + 1);
+          scales.back() = SplitUnit(name);
+          names.push_back(name);
+        }
+        columns.resize(names.size());
+        inTable = true;
+      }
+      else if (tokens[0] == "const") {
+        if (tokens.size() < 4) {
+          fail("const needs a target, a property name and a value");
+          return nLoaded;
+        }
+        Target t = GetTarget(tokens[1]);
+        if (t == kNoTarget) { fail("unknown target"); return nLoaded; }
+        G4String name = tokens[2];
+        G4double scale = SplitUnit(name);
+        AddConstant(t, name, G4UIcommand::ConvertToDouble(tokens[3])*scale);
+        ++nLoaded;
+      }
+      else {
+        fail("unknown directive");
+        return nLoaded;
+      }
+    }
+    line = eol + 1;
+  }
+  if (inTable) flush();
+
+  return nLoaded;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int PropertyLoader::ParseBinary(const char* p, const char* end)
+{
+  // layout (native byte order, values in internal units):
+  //   uint32 version, uint32 nBlocks
+  //   per block: uint8 kind (0 vector, 1 constant), uint8 target,
+  //              uint16 nameLength, char name[nameLength],
+  //              kind 0: uint32 n, double energies[n], double values[n]
+  //              kind 1: double value
+  G4int nLoaded = 0;
+  uint32_t version = 0, nBlocks = 0;
+  G4bool ok = ReadPOD(p, end, version) && ReadPOD(p, end, nBlocks);
+  if (ok && version != kBinaryVersion) ok = false;
+
+  for (uint32_t b = 0; ok && b < nBlocks; ++b) {
+    uint8_t kind = 0, target = 0;
+    uint16_t nameLength = 0;
+    ok = ReadPOD(p, end, kind) && ReadPOD(p, end, target) &&
+         ReadPOD(p, end, nameLength) && end - p >= nameLength &&
+         target < kNoTarget;
+    if (!ok) break;
+    G4String name(p, nameLength);
+    p += nameLength;
+
+    if (kind == 0) {
+      uint32_t n = 0;
+      ok = ReadPOD(p, end, n) &&
+           (size_t)(end - p) >= 2 * n * sizeof(G4double);
+      if (!ok) break;
+      std::vector<G4double> energies(n), values(n);
+      std::memcpy(energies.data(), p, n * sizeof(G4double));
+      p += n * sizeof(G4double);
+      std::memcpy(values.data(), p, n * sizeof(G4double));
+      p += n * sizeof(G4double);
+      AddVector(Target(target), name, energies, values);
+    }
+    else if (kind == 1) {
+      G4double value = 0.;
+      ok = ReadPOD(p, end, value);
+      if (!ok) break;
+      AddConstant(Target(target), name, value);
+    }
+    else {
+      ok = false;
+      break;
+    }
+    ++nLoaded;
+  }
+
+  if (!ok) {
+    G4ExceptionDescription ed;
+    ed << fFileName << ": corrupt or unsupported binary property file "
+       << "(block " << nLoaded << ")";
+    G4Exception("PropertyLoader::ParseBinary", "OpNovice2_005",
+                FatalException, ed);
+  }
+  return nLoaded;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+PropertyLoader::Target PropertyLoader::GetTarget(const G4String& s) const
+{
+  if (s == "box" || s == "tank") return kBox;
+  if (s == "world")              return kWorld;
+  if (s == "surface")            return kSurface;
+  return kNoTarget;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PropertyLoader::AddVector(Target target, const G4String& name,
+                               std::vector<G4double>& energies,
+                               std::vector<G4double>& values)
+{
+  size_t n = energies.size();
+  if (n == 0 || values.size() != n) return;
+
+  // the vector is built in one go, which needs ascending energies
+  if (!std::is_sorted(energies.begin(), energies.end())) {
+    std::vector<size_t> idx(n);
+    std::iota(idx.begin(), idx.end(), 0);
+    std::sort(idx.begin(), idx.end(),
+              [&](size_t a, size_t b) {return energies[a] < energies[b];});
+    std::vector<G4double> e(n), v(n);
+    for (size_t i = 0; i < n; ++i) {
+      e[i] = energies[idx[i]];
+      v[i] = values[idx[i]];
+    }
+    energies.swap(e);
+    values.swap(v);
+  }
+
+  G4MaterialPropertyVector* mpv =
+    new G4MaterialPropertyVector(energies.data(), values.data(), n);
+
+  if (target == kBox)          fDetector->AddTankMPV(name.c_str(), mpv);
+  else if (target == kWorld)   fDetector->AddWorldMPV(name.c_str(), mpv);
+  else if (target == kSurface) fDetector->AddSurfaceMPV(name.c_str(), mpv);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PropertyLoader::AddConstant(Target target, const G4String& name,
+                                 G4double value)
+{
+  if (target == kBox)          fDetector->AddTankMPCV(name.c_str(), value);
+  else if (target == kWorld)   fDetector->AddWorldMPCV(name.c_str(), value);
+  else if (target == kSurface) fDetector->AddSurfaceMPCV(name.c_str(), value);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -30,15 +30,84 @@
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+#include <cstring>
+#include <iomanip>
 #include <numeric>
+#include <sstream>
 
 #include "Run.hh"
 #include "DetectorConstruction.hh"
+#include "RunSummary.hh"
 
 #include "G4OpBoundaryProcess.hh"
 #include "G4SystemOfUnits.hh"
 #include "G4UnitsTable.hh"
 
+namespace {
+  inline uint64_t Mix(uint64_t h, uint64_t x)
+  {
+    h ^= x + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+    h = (h ^ (h >> 30))*0xbf58476d1ce4e5b9ULL;
+    h = (h ^ (h >> 27))*0x94d049bb133111ebULL;
+    return h ^ (h >> 31);
+  }
+
+  struct BoundaryName {
+    G4OpBoundaryProcessStatus status;
+    const char*               name;
+  };
+
+  // every status is written, also when zero, to keep the columns stable
+  const BoundaryName boundaryNames[] = {
+    {Transmission,                   "transmission"},
+    {FresnelRefraction,              "fresnel_refraction"},
+    {FresnelReflection,              "fresnel_reflection"},
+    {TotalInternalReflection,        "total_internal_reflection"},
+    {LambertianReflection,           "lambertian_reflection"},
+    {LobeReflection,                 "lobe_reflection"},
+    {SpikeReflection,                "spike_reflection"},
+    {BackScattering,                 "backscattering"},
+    {Absorption,                     "absorption"},
+    {Detection,                      "detection"},
+    {NotAtBoundary,                  "not_at_boundary"},
+    {SameMaterial,                   "same_material"},
+    {StepTooSmall,                   "step_too_small"},
+    {NoRINDEX,                       "no_rindex"},
+    {PolishedLumirrorAirReflection,  "polished_lumirror_air_reflection"},
+    {PolishedLumirrorGlueReflection, "polished_lumirror_glue_reflection"},
+    {PolishedAirReflection,          "polished_air_reflection"},
+    {PolishedTeflonAirReflection,    "polished_teflon_air_reflection"},
+    {PolishedTiOAirReflection,       "polished_tio_air_reflection"},
+    {PolishedTyvekAirReflection,     "polished_tyvek_air_reflection"},
+    {PolishedVM2000AirReflection,    "polished_vm2000_air_reflection"},
+    {PolishedVM2000GlueReflection,   "polished_vm2000_glue_reflection"},
+    {EtchedLumirrorAirReflection,    "etched_lumirror_air_reflection"},
+    {EtchedLumirrorGlueReflection,   "etched_lumirror_glue_reflection"},
+    {EtchedAirReflection,            "etched_air_reflection"},
+    {EtchedTeflonAirReflection,      "etched_teflon_air_reflection"},
+    {EtchedTiOAirReflection,         "etched_tio_air_reflection"},
+    {EtchedTyvekAirReflection,       "etched_tyvek_air_reflection"},
+    {EtchedVM2000AirReflection,      "etched_vm2000_air_reflection"},
+    {EtchedVM2000GlueReflection,     "etched_vm2000_glue_reflection"},
+    {GroundLumirrorAirReflection,    "ground_lumirror_air_reflection"},
+    {GroundLumirrorGlueReflection,   "ground_lumirror_glue_reflection"},
+    {GroundAirReflection,            "ground_air_reflection"},
+    {GroundTeflonAirReflection,      "ground_teflon_air_reflection"},
+    {GroundTiOAirReflection,         "ground_tio_air_reflection"},
+    {GroundTyvekAirReflection,       "ground_tyvek_air_reflection"},
+    {GroundVM2000AirReflection,      "ground_vm2000_air_reflection"},
+    {GroundVM2000GlueReflection,     "ground_vm2000_glue_reflection"},
+    {Dichroic,                       "dichroic"}
+  };
+
+  inline uint64_t Bits(G4double x)
+  {
+    uint64_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    return bits;
+  }
+}
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 Run::Run() 
 : G4Run()
@@ -58,6 +127,13 @@ Run::Run()
 
   fTotalSurface = 0;
 
+  fStepCount = 0;
+  fTrackedPhotons = 0;
+  fDetectedPhotons = 0;
+
+  fHitCount = 0;
+  fHitDigest = 0;
+
   fBoundaryProcs.clear();
   fBoundaryProcs.resize(40);
   for (G4int i = 0; i < 40; ++i) {
@@ -97,6 +173,18 @@ void Run::Merge(const G4Run* run)
   fOpAbsorption   += localRun->fOpAbsorption;
   fOpAbsorptionPrior += localRun->fOpAbsorptionPrior;
 
+  fStepCount      += localRun->fStepCount;
+  fTrackedPhotons += localRun->fTrackedPhotons;
+  fDetectedPhotons += localRun->fDetectedPhotons;
+  if (StepCensus::IsEnabled()) fCensus.Merge(localRun->fCensus);
+  if (MemoryMonitor::IsEnabled()) fMemory.Merge(localRun->fMemory);
+  fEventCost.Merge(localRun->fEventCost);
+  fPerf.Merge(localRun->fPerf);
+  fDetectorTally.Merge(localRun->fDetectorTally);
+  fEfficiencies.Merge(localRun->fEfficiencies);
+  fHitCount       += localRun->fHitCount;
+  fHitDigest      += localRun->fHitDigest;
+
   for (size_t i = 0; i < fBoundaryProcs.size(); ++i) {
     fBoundaryProcs[i] += localRun->fBoundaryProcs[i];
   }
@@ -327,4 +415,162 @@ void Run::EndOfRun()
 
   G4cout.setf(mode, std::ios::floatfield);
   G4cout.precision(prec);
+
+  PrintCounters();
+  fDetectorTally.Print(TotNbofEvents, fTrackedPhotons);
+  if (!DetectorTally::GetOutputFile().empty()) {
+    fDetectorTally.Write(DetectorTally::GetOutputFile());
+  }
+  fEfficiencies.Print();
+  fEventCost.Print();
+  if (MemoryMonitor::IsEnabled()) fMemory.Print();
+  if (StepCensus::IsEnabled()) {
+    fCensus.Print(20);
+    if (!StepCensus::GetOutputFile().empty()) {
+      fCensus.Write(StepCensus::GetOutputFile());
+    }
+  }
+  fPerf.Print(fStepCount);
+}
+
+void Run::AddHit(G4long event, G4int track, G4int pdg, G4int detector,
+                 const G4ThreeVector& position, G4double time)
+{
+  // a sum of row hashes does not depend on the order of the rows
+  uint64_t h = Mix(0, static_cast<uint64_t>(event));
+  h = Mix(h, static_cast<uint64_t>(track));
+  h = Mix(h, static_cast<uint64_t>(pdg));
+  h = Mix(h, static_cast<uint64_t>(detector));
+  h = Mix(h, Bits(position.x()));
+  h = Mix(h, Bits(position.y()));
+  h = Mix(h, Bits(position.z()));
+  h = Mix(h, Bits(time));
+  fHitDigest += h;
+  ++fHitCount;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool Run::EndEvent()
+{
+  G4long pass[Efficiencies::kNQuantities];
+  G4long total[Efficiencies::kNQuantities];
+  pass[Efficiencies::kDetection] = fDetectedPhotons;
+  total[Efficiencies::kDetection] = fTrackedPhotons;
+  pass[Efficiencies::kFresnelRefraction] = fBoundaryProcs[FresnelRefraction];
+  total[Efficiencies::kFresnelRefraction] = fTotalSurface;
+  pass[Efficiencies::kFresnelReflection] = fBoundaryProcs[FresnelReflection];
+  total[Efficiencies::kFresnelReflection] = fTotalSurface;
+  pass[Efficiencies::kAbsorptionPrior] = fOpAbsorptionPrior;
+  total[Efficiencies::kAbsorptionPrior] = fOpAbsorptionPrior + fTotalSurface;
+  return fEfficiencies.EndEvent(pass, total);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Run::PrintCounters() const
+{
+  std::ostringstream line;
+  line << std::setprecision(17)
+       << "Counters: events=" << numberOfEvent
+       << " cerenkov=" << fCerenkovCount
+       << " scintillation=" << fScintCount
+       << " cerenkovEnergy=" << fCerenkovEnergy/eV
+       << " scintillationEnergy=" << fScintEnergy/eV
+       << " rayleigh=" << fRayleighCount
+       << " absorption=" << fOpAbsorption
+       << " absorptionPrior=" << fOpAbsorptionPrior
+       << " surface=" << fTotalSurface
+       << " steps=" << fStepCount
+       << " trackedPhotons=" << fTrackedPhotons
+       << " hits=" << fHitCount
+       << " hitDigest=0x" << std::hex << std::setw(16) << std::setfill('0')
+       << fHitDigest << std::dec << std::setfill(' ');
+  for (size_t i = 0; i < fBoundaryProcs.size(); ++i) {
+    if (fBoundaryProcs[i] > 0) {
+      line << " boundary" << i << "=" << fBoundaryProcs[i];
+    }
+  }
+  G4cout << line.str() << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Run::FillSummary(RunSummary& summary) const
+{
+  const DetectorConstruction* det = (const DetectorConstruction*)
+    (G4RunManager::GetRunManager()->GetUserDetectorConstruction());
+  G4int events = numberOfEvent;
+  G4double perEvent = events > 0 ? 1./events : 0.;
+
+  summary.Add("configuration", "primary_particle",
+              fParticle ? fParticle->GetParticleName() : G4String(""));
+  summary.Add("configuration", "primary_energy_eV", fEkin/eV);
+  summary.Add("configuration", "world_material",
+              det->GetWorldMaterial()->GetName());
+  summary.Add("configuration", "tank_material",
+              det->GetTankMaterial()->GetName());
+
+  summary.Add("counters", "events", events);
+  summary.Add("counters", "cerenkov", fCerenkovCount);
+  summary.Add("counters", "scintillation", fScintCount);
+  summary.Add("counters", "cerenkov_energy_eV", fCerenkovEnergy/eV);
+  summary.Add("counters", "scintillation_energy_eV", fScintEnergy/eV);
+  summary.Add("counters", "rayleigh", fRayleighCount);
+  summary.Add("counters", "absorption", fOpAbsorption);
+  summary.Add("counters", "absorption_before_surface", fOpAbsorptionPrior);
+  summary.Add("counters", "surface_events", fTotalSurface);
+  summary.Add("counters", "steps", fStepCount);
+  summary.Add("counters", "tracked_photons", fTrackedPhotons);
+  summary.Add("counters", "detected_photons", fDetectedPhotons);
+  summary.Add("counters", "hits", fHitCount);
+  std::ostringstream digest;
+  digest << "0x" << std::hex << std::setw(16) << std::setfill('0')
+         << fHitDigest;
+  summary.Add("counters", "hit_digest", digest.str());
+
+  summary.Add("averages", "cerenkov_per_event", fCerenkovCount*perEvent);
+  summary.Add("averages", "cerenkov_energy_eV",
+              fCerenkovCount > 0 ? fCerenkovEnergy/eV/fCerenkovCount : 0.);
+  summary.Add("averages", "scintillation_per_event", fScintCount*perEvent);
+  summary.Add("averages", "scintillation_energy_eV",
+              fScintCount > 0 ? fScintEnergy/eV/fScintCount : 0.);
+  summary.Add("averages", "rayleigh_per_event", fRayleighCount*perEvent);
+  summary.Add("averages", "absorption_per_event", fOpAbsorption*perEvent);
+
+  G4int sum = std::accumulate(fBoundaryProcs.begin(), fBoundaryProcs.end(), 0);
+  for (size_t i = 0; i < sizeof(boundaryNames)/sizeof(boundaryNames[0]); ++i) {
+    summary.Add("boundary", boundaryNames[i].name,
+                fBoundaryProcs[boundaryNames[i].status]);
+  }
+  summary.Add("boundary", "sum", sum);
+  summary.Add("boundary", "unaccounted", fTotalSurface - sum);
+
+  fEventCost.FillSummary(summary);
+
+  for (G4int i = 0; i < PerfCounters::kNCounters; ++i) {
+    PerfCounters::Counter c = PerfCounters::Counter(i);
+    G4String key = PerfCounters::GetCounterName(c);
+    for (size_t k = 0; k < key.size(); ++k) if (key[k] == ' ') key[k] = '_';
+    if (fPerf.IsAvailable(c)) summary.Add("perf_counters", key, fPerf.Get(c));
+    else summary.AddNull("perf_counters", key);
+  }
+  if (fPerf.GetIPC() > 0.) summary.Add("perf_counters", "ipc", fPerf.GetIPC());
+  else summary.AddNull("perf_counters", "ipc");
+  // as on the Benchmark line
+  const PerfCounters::Counter misses[] =
+    {PerfCounters::kCacheMisses, PerfCounters::kBranchMisses};
+  const char* missKeys[] = {"cache_misses_per_step", "branch_misses_per_step"};
+  for (G4int i = 0; i < 2; ++i) {
+    if (fStepCount > 0 && fPerf.IsAvailable(misses[i])) {
+      summary.Add("perf_counters", missKeys[i],
+                  fPerf.Get(misses[i])/fStepCount);
+    }
+    else summary.AddNull("perf_counters", missKeys[i]);
+  }
+
+  fDetectorTally.FillSummary(summary, events);
+  fEfficiencies.FillSummary(summary);
 }
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -5,9 +5,24 @@
 #include "HistoManager.hh"
 #include "PrimaryGeneratorAction.hh"
 #include "B5EventAction.hh"
+#include "PhysicsList.hh"
+#include "ProcessInfo.hh"
+#include "RunMessenger.hh"
+#include "StageTimer.hh"
+#include "ProgressMonitor.hh"
+#include "PerfCounters.hh"
+#include "EventSeeder.hh"
+#include "RunSummary.hh"
+#include "Efficiencies.hh"
+#include "TrackInformation.hh"
 
 #include "Run.hh"
 #include "G4Run.hh"
+#include "G4RunManagerKernel.hh"
+#include "G4Threading.hh"
+#ifdef G4MULTITHREADED
+#include "G4MTRunManager.hh"
+#endif
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
@@ -17,10 +32,13 @@ RunAction::RunAction(PrimaryGeneratorAction* prim, B5EventAction *evtAct)
     fRun(nullptr),
     fHistoManager(nullptr),
     fPrimary(prim),
-    fEventAction(evtAct)
+    fEventAction(evtAct),
+    fStartupTime(0.),
+    fMessenger(nullptr)
 {
   fTimer = new G4Timer;
   fHistoManager = new HistoManager();
+  fMessenger = new RunMessenger();
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -29,6 +47,7 @@ RunAction::~RunAction()
 {
   delete fTimer;
   delete fHistoManager;
+  delete fMessenger;
 }
 
 G4Run* RunAction::GenerateRun()
@@ -43,6 +62,23 @@ void RunAction::BeginOfRunAction(const G4Run* aRun)
 {
   G4cout << "### Run " << aRun->GetRunID() << " start." << G4endl;
 
+  PhysicsList* physics = dynamic_cast<PhysicsList*>(
+    G4RunManagerKernel::GetRunManagerKernel()->GetPhysicsList());
+  // every thread applies the /opnovice2/physics/ settings to its processes
+  if (physics) physics->ApplyOpticalSettings();
+
+  // the first run is set up once the physics tables are built, so this
+  // is the start-up cost of the chosen physics list
+  if (isMaster && aRun->GetRunID() == 0) {
+    if (physics) physics->StoreTableCache();
+    fStartupTime = ProcessInfo::GetElapsedTime();
+    G4cout << "### Start-up";
+    if (physics) G4cout << " (" << physics->GetMode() << " physics)";
+    G4cout << ": " << fStartupTime << " s, RSS "
+           << ProcessInfo::GetResidentMemory() << " MB, peak RSS "
+           << ProcessInfo::GetPeakResidentMemory() << " MB" << G4endl;
+  }
+
   if (fPrimary) {
     G4ParticleDefinition* particle = 
       fPrimary->GetParticleGun()->GetParticleDefinition();
@@ -52,6 +88,7 @@ void RunAction::BeginOfRunAction(const G4Run* aRun)
 
   G4AnalysisManager* analysisManager = G4AnalysisManager::Instance();
   analysisManager->SetVerboseLevel(1);
+  analysisManager->SetNtupleActivation(1, TrackInformation::GetWriteHistory());
   analysisManager->OpenFile();
 
   // if (analysisManager->IsActive()) {
@@ -62,6 +99,18 @@ void RunAction::BeginOfRunAction(const G4Run* aRun)
   //   G4cout<<"something is wrong here"<<G4endl;
   //   std::cin.ignore();
   // }
+  StageTimer::Reset();
+  // counters of the threads that process events
+  if (!isMaster || !G4Threading::IsMultithreadedApplication()) {
+    fRun->GetPerfCounters().BeginRun();
+  }
+  if (isMaster) {
+    // before the workers start their event loops
+    Efficiencies::ResetTarget();
+    ProgressMonitor::Start(aRun->GetRunID(),
+                           aRun->GetNumberOfEventToBeProcessed(),
+                           analysisManager->GetFileName());
+  }
   fTimer->Start();
 }
 
@@ -70,10 +119,49 @@ void RunAction::BeginOfRunAction(const G4Run* aRun)
 void RunAction::EndOfRunAction(const G4Run* aRun)
 {
   fTimer->Stop();
+  if (isMaster) ProgressMonitor::Stop();
+  PerfCounters::EndRun();
   G4cout << "number of event = " << aRun->GetNumberOfEvent()
          << " " << *fTimer << G4endl;
-
-  if (isMaster) fRun->EndOfRun();
+  StageTimer::Report();
+
+  if (isMaster) {
+    fRun->EndOfRun();
+
+    // throughput with the current optical settings
+    const PhysicsList* physics = dynamic_cast<const PhysicsList*>(
+      G4RunManagerKernel::GetRunManagerKernel()->GetPhysicsList());
+    if (physics) physics->PrintOpticalSettings();
+    G4double realTime = fTimer->GetRealElapsed();
+    if (realTime > 0.) {
+      G4cout << "Throughput: " << aRun->GetNumberOfEvent()/realTime
+             << " events/s, "
+             << (fRun->GetCerenkovCount() + fRun->GetScintillationCount())
+                /realTime
+             << " optical photons created/s" << G4endl;
+    }
+    // one line for bench/run_bench.py
+    G4cout << "Benchmark: events=" << aRun->GetNumberOfEvent()
+           << " seconds=" << realTime
+           << " steps=" << fRun->GetStepCount()
+           << " trackedPhotons=" << fRun->GetTrackedPhotons()
+           << " startup=" << fStartupTime
+           << " peakRSS=" << ProcessInfo::GetPeakResidentMemory();
+    const PerfCounters& perf = fRun->GetPerfCounters();
+    G4long steps = fRun->GetStepCount();
+    if (perf.GetIPC() > 0.) G4cout << " ipc=" << perf.GetIPC();
+    if (steps > 0 && perf.IsAvailable(PerfCounters::kCacheMisses)) {
+      G4cout << " cacheMissesPerStep="
+             << perf.Get(PerfCounters::kCacheMisses)/steps;
+    }
+    if (steps > 0 && perf.IsAvailable(PerfCounters::kBranchMisses)) {
+      G4cout << " branchMissesPerStep="
+             << perf.Get(PerfCounters::kBranchMisses)/steps;
+    }
+    G4cout << G4endl;
+
+    WriteSummary(aRun);
+  }
 
   // save histograms
   G4AnalysisManager* analysisManager = G4AnalysisManager::Instance();
@@ -82,3 +170,44 @@ void RunAction::EndOfRunAction(const G4Run* aRun)
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RunAction::WriteSummary(const G4Run* aRun)
+{
+  if (RunSummary::GetFormat() == "none") return;
+
+  G4int threads = 1;
+#ifdef G4MULTITHREADED
+  G4MTRunManager* mtManager =
+    dynamic_cast<G4MTRunManager*>(G4RunManager::GetRunManager());
+  if (mtManager) threads = mtManager->GetNumberOfThreads();
+#endif
+  const PhysicsList* physics = dynamic_cast<const PhysicsList*>(
+    G4RunManagerKernel::GetRunManagerKernel()->GetPhysicsList());
+  G4AnalysisManager* analysisManager = G4AnalysisManager::Instance();
+
+  RunSummary summary;
+  summary.Add("configuration", "run_id", aRun->GetRunID());
+  summary.Add("configuration", "events_requested",
+              aRun->GetNumberOfEventToBeProcessed());
+  summary.Add("configuration", "threads", threads);
+  summary.Add("configuration", "physics_mode",
+              physics ? physics->GetMode() : G4String(""));
+  summary.Add("configuration", "event_seed", EventSeeder::GetSeed());
+  summary.Add("configuration", "event_offset", EventSeeder::GetOffset());
+  summary.Add("configuration", "analysis_file",
+              analysisManager->GetFileName());
+  fRun->FillSummary(summary);
+
+  G4double realTime = fTimer->GetRealElapsed();
+  summary.Add("timing", "real_s", realTime);
+  summary.Add("timing", "user_s", fTimer->GetUserElapsed());
+  summary.Add("timing", "system_s", fTimer->GetSystemElapsed());
+  summary.Add("timing", "startup_s", fStartupTime);
+  summary.Add("timing", "events_per_s",
+              realTime > 0. ? aRun->GetNumberOfEvent()/realTime : 0.);
+  summary.Add("timing", "peak_rss_MB", ProcessInfo::GetPeakResidentMemory());
+
+  summary.Write(analysisManager->GetFileName(), aRun->GetRunID());
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,438 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/src/RunMessenger.cc
+/// \brief Implementation of the RunMessenger class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "RunMessenger.hh"
+
+#include "StageTimer.hh"
+#include "StepCensus.hh"
+#include "MemoryMonitor.hh"
+#include "EventCost.hh"
+#include "ProgressMonitor.hh"
+#include "PerfCounters.hh"
+#include "EventSeeder.hh"
+#include "RunSummary.hh"
+#include "DetectorTally.hh"
+#include "Efficiencies.hh"
+#include "TrackInformation.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithADouble.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+RunMessenger::RunMessenger()
+  : G4UImessenger()
+{
+  fRunDir = new G4UIdirectory("/opnovice2/run/");
+  fRunDir->SetGuidance("Run instrumentation and control");
+
+  fStageTimersCmd = new G4UIcmdWithABool("/opnovice2/run/stageTimers", this);
+  fStageTimersCmd->SetGuidance("Time the stages of the user actions and");
+  fStageTimersCmd->SetGuidance(" print a per-thread breakdown at end of run.");
+  fStageTimersCmd->SetGuidance(" Needs a build with OPNOVICE2_STAGE_TIMERS.");
+  fStageTimersCmd->SetParameterName("flag", true);
+  fStageTimersCmd->SetDefaultValue(true);
+  fStageTimersCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fStageTimersCmd->SetToBeBroadcasted(false);
+
+  fCensusCmd = new G4UIcmdWithABool("/opnovice2/run/census", this);
+  fCensusCmd->SetGuidance("Count steps, tracks and time per particle,");
+  fCensusCmd->SetGuidance(" volume and step-limiting process, and print");
+  fCensusCmd->SetGuidance(" the table at end of run.");
+  fCensusCmd->SetParameterName("flag", true);
+  fCensusCmd->SetDefaultValue(true);
+  fCensusCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fCensusCmd->SetToBeBroadcasted(false);
+
+  fCensusFileCmd = new G4UIcmdWithAString("/opnovice2/run/censusFile", this);
+  fCensusFileCmd->SetGuidance("Also write the full census as CSV.");
+  fCensusFileCmd->SetParameterName("fileName", false);
+  fCensusFileCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fCensusFileCmd->SetToBeBroadcasted(false);
+
+  fMemoryCmd = new G4UIcmdWithABool("/opnovice2/run/memory", this);
+  fMemoryCmd->SetGuidance("Record stack depth, allocator pool, RSS and");
+  fMemoryCmd->SetGuidance(" ntuple rows per event and check the budgets.");
+  fMemoryCmd->SetParameterName("flag", true);
+  fMemoryCmd->SetDefaultValue(true);
+  fMemoryCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fMemoryCmd->SetToBeBroadcasted(false);
+
+  fStackBudgetCmd =
+    new G4UIcmdWithAnInteger("/opnovice2/run/budgetStackDepth", this);
+  fStackBudgetCmd->SetGuidance("Warn when an event stacks more tracks;");
+  fStackBudgetCmd->SetGuidance(" 0 for no limit.");
+  fStackBudgetCmd->SetParameterName("tracks", false);
+  fStackBudgetCmd->SetRange("tracks>=0");
+  fStackBudgetCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fStackBudgetCmd->SetToBeBroadcasted(false);
+
+  fRSSBudgetCmd = new G4UIcmdWithADouble("/opnovice2/run/budgetRSS", this);
+  fRSSBudgetCmd->SetGuidance("Warn when the process RSS in MB exceeds this");
+  fRSSBudgetCmd->SetGuidance(" at the end of an event; 0 for no limit.");
+  fRSSBudgetCmd->SetParameterName("MB", false);
+  fRSSBudgetCmd->SetRange("MB>=0.");
+  fRSSBudgetCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fRSSBudgetCmd->SetToBeBroadcasted(false);
+
+  fAllocatorBudgetCmd =
+    new G4UIcmdWithADouble("/opnovice2/run/budgetAllocator", this);
+  fAllocatorBudgetCmd->SetGuidance("Warn when a thread's TrackInformation");
+  fAllocatorBudgetCmd->SetGuidance(" pool in MB exceeds this; 0 for no limit.");
+  fAllocatorBudgetCmd->SetParameterName("MB", false);
+  fAllocatorBudgetCmd->SetRange("MB>=0.");
+  fAllocatorBudgetCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fAllocatorBudgetCmd->SetToBeBroadcasted(false);
+
+  fNtupleRowBudgetCmd =
+    new G4UIcmdWithAnInteger("/opnovice2/run/budgetNtupleRows", this);
+  fNtupleRowBudgetCmd->SetGuidance("Warn when an event fills more ntuple");
+  fNtupleRowBudgetCmd->SetGuidance(" rows; 0 for no limit.");
+  fNtupleRowBudgetCmd->SetParameterName("rows", false);
+  fNtupleRowBudgetCmd->SetRange("rows>=0");
+  fNtupleRowBudgetCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fNtupleRowBudgetCmd->SetToBeBroadcasted(false);
+
+  fSlowPercentileCmd =
+    new G4UIcmdWithADouble("/opnovice2/run/slowEventPercentile", this);
+  fSlowPercentileCmd->SetGuidance("Log events slower than this percentile");
+  fSlowPercentileCmd->SetGuidance(" of the events so far, e.g. 99; 0 (default)");
+  fSlowPercentileCmd->SetGuidance(" switches the log off. The log gives the");
+  fSlowPercentileCmd->SetGuidance(" event seeds with /opnovice2/run/eventSeed;");
+  fSlowPercentileCmd->SetGuidance(" with /random/setSavingFlag 1 the engine");
+  fSlowPercentileCmd->SetGuidance(" status is saved for replay.");
+  fSlowPercentileCmd->SetParameterName("percentile", false);
+  fSlowPercentileCmd->SetRange("percentile>=0. && percentile<100.");
+  fSlowPercentileCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fSlowPercentileCmd->SetToBeBroadcasted(false);
+
+  fWorstEventsCmd =
+    new G4UIcmdWithAnInteger("/opnovice2/run/worstEvents", this);
+  fWorstEventsCmd->SetGuidance("Number of most expensive events listed in");
+  fWorstEventsCmd->SetGuidance(" the run summary (default 5).");
+  fWorstEventsCmd->SetParameterName("n", false);
+  fWorstEventsCmd->SetRange("n>=0");
+  fWorstEventsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fWorstEventsCmd->SetToBeBroadcasted(false);
+
+  fProgressCmd = new G4UIcmdWithADouble("/opnovice2/run/progress", this);
+  fProgressCmd->SetGuidance("Print the events/s, steps/s, photons/s,");
+  fProgressCmd->SetGuidance(" output MB/s and ETA of the whole run every");
+  fProgressCmd->SetGuidance(" this many seconds; 0 switches it off.");
+  fProgressCmd->SetParameterName("seconds", false);
+  fProgressCmd->SetRange("seconds>=0.");
+  fProgressCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fProgressCmd->SetToBeBroadcasted(false);
+
+  fProgressFileCmd =
+    new G4UIcmdWithAString("/opnovice2/run/progressFile", this);
+  fProgressFileCmd->SetGuidance("Also write the progress as JSON to this");
+  fProgressFileCmd->SetGuidance(" file, replaced atomically at each update.");
+  fProgressFileCmd->SetParameterName("fileName", false);
+  fProgressFileCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fProgressFileCmd->SetToBeBroadcasted(false);
+
+  fPerfCountersCmd = new G4UIcmdWithABool("/opnovice2/run/perfCounters", this);
+  fPerfCountersCmd->SetGuidance("Read cycles, instructions, cache and branch");
+  fPerfCountersCmd->SetGuidance(" misses of the event loop from the hardware");
+  fPerfCountersCmd->SetGuidance(" counters (Linux perf_event_open).");
+  fPerfCountersCmd->SetParameterName("flag", true);
+  fPerfCountersCmd->SetDefaultValue(true);
+  fPerfCountersCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fPerfCountersCmd->SetToBeBroadcasted(false);
+
+  fPerfSectionsCmd = new G4UIcmdWithABool("/opnovice2/run/perfSections", this);
+  fPerfSectionsCmd->SetGuidance("Also split the counts into our stepping,");
+  fPerfSectionsCmd->SetGuidance(" tracking and event actions and the rest;");
+  fPerfSectionsCmd->SetGuidance(" costs two counter reads per call.");
+  fPerfSectionsCmd->SetParameterName("flag", true);
+  fPerfSectionsCmd->SetDefaultValue(true);
+  fPerfSectionsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fPerfSectionsCmd->SetToBeBroadcasted(false);
+
+  fEventSeedCmd = new G4UIcmdWithAnInteger("/opnovice2/run/eventSeed", this);
+  fEventSeedCmd->SetGuidance("Seed every event from this seed and its");
+  fEventSeedCmd->SetGuidance(" global number, so the results do not depend");
+  fEventSeedCmd->SetGuidance(" on the number of threads or shards;");
+  fEventSeedCmd->SetGuidance(" 0 (default) keeps the Geant4 seeding.");
+  fEventSeedCmd->SetParameterName("seed", false);
+  fEventSeedCmd->SetRange("seed>=0");
+  fEventSeedCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fEventSeedCmd->SetToBeBroadcasted(false);
+
+  fEventOffsetCmd =
+    new G4UIcmdWithAnInteger("/opnovice2/run/eventOffset", this);
+  fEventOffsetCmd->SetGuidance("Global number of the first event of the");
+  fEventOffsetCmd->SetGuidance(" next runs, for a job that is one shard of");
+  fEventOffsetCmd->SetGuidance(" a larger sample.");
+  fEventOffsetCmd->SetParameterName("offset", false);
+  fEventOffsetCmd->SetRange("offset>=0");
+  fEventOffsetCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fEventOffsetCmd->SetToBeBroadcasted(false);
+
+  fSummaryFormatCmd =
+    new G4UIcmdWithAString("/opnovice2/run/summaryFormat", this);
+  fSummaryFormatCmd->SetGuidance("Write the run summary next to the analysis");
+  fSummaryFormatCmd->SetGuidance(" file as <file>_run<R>.json and/or .csv");
+  fSummaryFormatCmd->SetGuidance(" (default json).");
+  fSummaryFormatCmd->SetParameterName("format", false);
+  fSummaryFormatCmd->SetCandidates("none json csv both");
+  fSummaryFormatCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fSummaryFormatCmd->SetToBeBroadcasted(false);
+
+  fTimeSpectrumCmd = new G4UIcommand("/opnovice2/run/timeSpectrum", this);
+  fTimeSpectrumCmd->SetGuidance("Binning of the arrival-time spectrum of the");
+  fTimeSpectrumCmd->SetGuidance(" photons at the readout planes");
+  fTimeSpectrumCmd->SetGuidance(" (default 1000 bins from 0 to 100 ns).");
+  G4UIparameter* param = new G4UIparameter("bins", 'i', false);
+  param->SetParameterRange("bins > 0");
+  fTimeSpectrumCmd->SetParameter(param);
+  param = new G4UIparameter("min", 'd', false);
+  fTimeSpectrumCmd->SetParameter(param);
+  param = new G4UIparameter("max", 'd', false);
+  fTimeSpectrumCmd->SetParameter(param);
+  param = new G4UIparameter("unit", 's', true);
+  param->SetDefaultValue("ns");
+  fTimeSpectrumCmd->SetParameter(param);
+  fTimeSpectrumCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fTimeSpectrumCmd->SetToBeBroadcasted(false);
+
+  fWavelengthSpectrumCmd =
+    new G4UIcommand("/opnovice2/run/wavelengthSpectrum", this);
+  fWavelengthSpectrumCmd->SetGuidance("Binning of the wavelength spectrum of");
+  fWavelengthSpectrumCmd->SetGuidance(" the photons at the readout planes");
+  fWavelengthSpectrumCmd->SetGuidance(" (default 600 bins from 200 to 800 nm).");
+  param = new G4UIparameter("bins", 'i', false);
+  param->SetParameterRange("bins > 0");
+  fWavelengthSpectrumCmd->SetParameter(param);
+  param = new G4UIparameter("min", 'd', false);
+  fWavelengthSpectrumCmd->SetParameter(param);
+  param = new G4UIparameter("max", 'd', false);
+  fWavelengthSpectrumCmd->SetParameter(param);
+  param = new G4UIparameter("unit", 's', true);
+  param->SetDefaultValue("nm");
+  fWavelengthSpectrumCmd->SetParameter(param);
+  fWavelengthSpectrumCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fWavelengthSpectrumCmd->SetToBeBroadcasted(false);
+
+  fSpectraFileCmd = new G4UIcmdWithAString("/opnovice2/run/spectraFile", this);
+  fSpectraFileCmd->SetGuidance("Also write the arrival-time and wavelength");
+  fSpectraFileCmd->SetGuidance(" spectra as CSV at end of run.");
+  fSpectraFileCmd->SetParameterName("fileName", false);
+  fSpectraFileCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fSpectraFileCmd->SetToBeBroadcasted(false);
+
+  fBeamUntilCmd = new G4UIcommand("/opnovice2/run/beamUntil", this);
+  fBeamUntilCmd->SetGuidance("Stop the run once the efficiencies reach this");
+  fBeamUntilCmd->SetGuidance(" relative error; /run/beamOn N is then an upper");
+  fBeamUntilCmd->SetGuidance(" limit. Quantities: detection fresnelRefraction");
+  fBeamUntilCmd->SetGuidance(" fresnelReflection absorptionPrior (default");
+  fBeamUntilCmd->SetGuidance(" detection). 0 runs all the events.");
+  param = new G4UIparameter("relativeError", 'd', false);
+  param->SetParameterRange("relativeError >= 0.");
+  fBeamUntilCmd->SetParameter(param);
+  param = new G4UIparameter("quantities", 's', true);
+  param->SetDefaultValue("detection");
+  fBeamUntilCmd->SetParameter(param);
+  fBeamUntilCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fBeamUntilCmd->SetToBeBroadcasted(false);
+
+  fBatchSizeCmd = new G4UIcmdWithAnInteger("/opnovice2/run/batchSize", this);
+  fBatchSizeCmd->SetGuidance("Events per batch for the batch-means errors of");
+  fBatchSizeCmd->SetGuidance(" the efficiencies (default 100).");
+  fBatchSizeCmd->SetParameterName("events", false);
+  fBatchSizeCmd->SetRange("events > 0");
+  fBatchSizeCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fBatchSizeCmd->SetToBeBroadcasted(false);
+
+  fPhotonHistoryCmd =
+    new G4UIcmdWithABool("/opnovice2/run/photonHistory", this);
+  fPhotonHistoryCmd->SetGuidance("Write the history of the photons reaching a");
+  fPhotonHistoryCmd->SetGuidance(" readout plane (creator, bounces, total");
+  fPhotonHistoryCmd->SetGuidance(" internal reflections, path in the tank,");
+  fPhotonHistoryCmd->SetGuidance(" first boundary status) to the history ntuple.");
+  fPhotonHistoryCmd->SetParameterName("flag", true);
+  fPhotonHistoryCmd->SetDefaultValue(true);
+  fPhotonHistoryCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fPhotonHistoryCmd->SetToBeBroadcasted(false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+RunMessenger::~RunMessenger()
+{
+  delete fStageTimersCmd;
+  delete fCensusCmd;
+  delete fCensusFileCmd;
+  delete fMemoryCmd;
+  delete fStackBudgetCmd;
+  delete fRSSBudgetCmd;
+  delete fAllocatorBudgetCmd;
+  delete fNtupleRowBudgetCmd;
+  delete fSlowPercentileCmd;
+  delete fWorstEventsCmd;
+  delete fProgressCmd;
+  delete fProgressFileCmd;
+  delete fPerfCountersCmd;
+  delete fPerfSectionsCmd;
+  delete fEventSeedCmd;
+  delete fEventOffsetCmd;
+  delete fSummaryFormatCmd;
+  delete fTimeSpectrumCmd;
+  delete fWavelengthSpectrumCmd;
+  delete fSpectraFileCmd;
+  delete fBeamUntilCmd;
+  delete fBatchSizeCmd;
+  delete fPhotonHistoryCmd;
+  delete fRunDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RunMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+  if (command == fStageTimersCmd) {
+    StageTimer::SetEnabled(fStageTimersCmd->GetNewBoolValue(newValue));
+  }
+  else if (command == fCensusCmd) {
+    StepCensus::SetEnabled(fCensusCmd->GetNewBoolValue(newValue));
+  }
+  else if (command == fCensusFileCmd) {
+    StepCensus::SetOutputFile(newValue);
+  }
+  else if (command == fMemoryCmd) {
+    MemoryMonitor::SetEnabled(fMemoryCmd->GetNewBoolValue(newValue));
+  }
+  else if (command == fStackBudgetCmd) {
+    MemoryMonitor::SetStackBudget(fStackBudgetCmd->GetNewIntValue(newValue));
+  }
+  else if (command == fRSSBudgetCmd) {
+    MemoryMonitor::SetRSSBudget(fRSSBudgetCmd->GetNewDoubleValue(newValue));
+  }
+  else if (command == fAllocatorBudgetCmd) {
+    MemoryMonitor::SetAllocatorBudget(
+      fAllocatorBudgetCmd->GetNewDoubleValue(newValue));
+  }
+  else if (command == fNtupleRowBudgetCmd) {
+    MemoryMonitor::SetNtupleRowBudget(
+      fNtupleRowBudgetCmd->GetNewIntValue(newValue));
+  }
+  else if (command == fSlowPercentileCmd) {
+    EventCost::SetSlowPercentile(
+      fSlowPercentileCmd->GetNewDoubleValue(newValue));
+  }
+  else if (command == fWorstEventsCmd) {
+    EventCost::SetNumberOfWorst(fWorstEventsCmd->GetNewIntValue(newValue));
+  }
+  else if (command == fProgressCmd) {
+    ProgressMonitor::SetInterval(fProgressCmd->GetNewDoubleValue(newValue));
+  }
+  else if (command == fProgressFileCmd) {
+    ProgressMonitor::SetStatusFile(newValue);
+  }
+  else if (command == fPerfCountersCmd) {
+    PerfCounters::SetEnabled(fPerfCountersCmd->GetNewBoolValue(newValue));
+  }
+  else if (command == fPerfSectionsCmd) {
+    PerfCounters::SetSections(fPerfSectionsCmd->GetNewBoolValue(newValue));
+  }
+  else if (command == fEventSeedCmd) {
+    EventSeeder::SetSeed(fEventSeedCmd->GetNewIntValue(newValue));
+  }
+  else if (command == fEventOffsetCmd) {
+    EventSeeder::SetOffset(fEventOffsetCmd->GetNewIntValue(newValue));
+  }
+  else if (command == fSummaryFormatCmd) {
+    RunSummary::SetFormat(newValue);
+  }
+  else if (command == fTimeSpectrumCmd || command == fWavelengthSpectrumCmd) {
+    std::istringstream instring(newValue);
+    G4int bins;
+    G4double min, max;
+    G4String unit;
+    instring >> bins >> min >> max >> unit;
+    G4double scale = G4UIcommand::ValueOf(unit);
+    if (max <= min || scale <= 0.) {
+      G4ExceptionDescription ed;
+      ed << "Spectrum range " << min << " - " << max << " " << unit
+         << " is not valid, the binning is not changed.";
+      G4Exception("RunMessenger::SetNewValue", "OpNovice2_025",
+                  JustWarning, ed);
+    }
+    else if (command == fTimeSpectrumCmd) {
+      DetectorTally::SetTimeBinning(bins, min*scale, max*scale);
+    }
+    else {
+      DetectorTally::SetWavelengthBinning(bins, min*scale, max*scale);
+    }
+  }
+  else if (command == fSpectraFileCmd) {
+    DetectorTally::SetOutputFile(newValue);
+  }
+  else if (command == fBeamUntilCmd) {
+    std::istringstream instring(newValue);
+    G4double precision;
+    instring >> precision;
+    G4int mask = 0;
+    G4String name;
+    while (instring >> name) {
+      Efficiencies::Quantity q;
+      if (Efficiencies::FindQuantity(name, q)) {
+        mask |= 1 << q;
+      }
+      else {
+        G4ExceptionDescription ed;
+        ed << "Unknown efficiency " << name << ", ignored.";
+        G4Exception("RunMessenger::SetNewValue", "OpNovice2_026",
+                    JustWarning, ed);
+      }
+    }
+    if (mask == 0) mask = 1 << Efficiencies::kDetection;
+    Efficiencies::SetTarget(precision, mask);
+  }
+  else if (command == fBatchSizeCmd) {
+    Efficiencies::SetBatchSize(fBatchSizeCmd->GetNewIntValue(newValue));
+  }
+  else if (command == fPhotonHistoryCmd) {
+    TrackInformation::SetWriteHistory(
+      fPhotonHistoryCmd->GetNewBoolValue(newValue));
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
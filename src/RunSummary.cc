@@ -0,0 +1,241 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/src/RunSummary.cc
+/// \brief Implementation of the RunSummary class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "RunSummary.hh"
+
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace {
+  G4String format = "json";
+
+  std::string JSONString(const G4String& text)
+  {
+    std::string out = "\"";
+    for (size_t i = 0; i < text.size(); ++i) {
+      char c = text[i];
+      if (c == '"' || c == '\\') out += '\\';
+      if (static_cast<unsigned char>(c) < 0x20) c = ' ';
+      out += c;
+    }
+    return out + "\"";
+  }
+
+  std::string CSVString(const G4String& text)
+  {
+    std::string out = "\"";
+    for (size_t i = 0; i < text.size(); ++i) {
+      if (text[i] == '"') out += '"';
+      out += text[i];
+    }
+    return out + "\"";
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RunSummary::SetFormat(const G4String& value) {format = value;}
+
+const G4String& RunSummary::GetFormat() {return format;}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+RunSummary::RunSummary()
+{
+  Add("summary", "format", "opnovice2-run-summary");
+  Add("summary", "version", kVersion);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+RunSummary::~RunSummary()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RunSummary::AddEntry(const G4String& section, const G4String& key,
+                          const G4String& value, G4bool quoted)
+{
+  Entry entry;
+  entry.section = section;
+  entry.key     = key;
+  entry.value   = value;
+  entry.quoted  = quoted;
+  fEntries.push_back(entry);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RunSummary::Add(const G4String& section, const G4String& key,
+                     G4double value)
+{
+  if (!std::isfinite(value)) {
+    AddNull(section, key);
+    return;
+  }
+  std::ostringstream text;
+  text << std::setprecision(12) << value;
+  AddEntry(section, key, text.str(), false);
+}
+
+void RunSummary::Add(const G4String& section, const G4String& key,
+                     G4long value)
+{
+  std::ostringstream text;
+  text << value;
+  AddEntry(section, key, text.str(), false);
+}
+
+void RunSummary::Add(const G4String& section, const G4String& key,
+                     G4int value)
+{
+  Add(section, key, static_cast<G4long>(value));
+}
+
+void RunSummary::Add(const G4String& section, const G4String& key,
+                     G4bool value)
+{
+  AddEntry(section, key, value ? "true" : "false", false);
+}
+
+void RunSummary::Add(const G4String& section, const G4String& key,
+                     const G4String& value)
+{
+  AddEntry(section, key, value, true);
+}
+
+void RunSummary::Add(const G4String& section, const G4String& key,
+                     const char* value)
+{
+  AddEntry(section, key, value, true);
+}
+
+void RunSummary::AddNull(const G4String& section, const G4String& key)
+{
+  AddEntry(section, key, "null", false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RunSummary::Write(const G4String& analysisFile, G4int runID) const
+{
+  if (format == "none") return;
+
+  G4String base = analysisFile;
+  std::string::size_type dot = base.rfind('.');
+  std::string::size_type slash = base.rfind('/');
+  if (dot != std::string::npos &&
+      (slash == std::string::npos || dot > slash)) {
+    base = base.substr(0, dot);
+  }
+  std::ostringstream name;
+  name << base << "_run" << runID;
+
+  if (format == "json" || format == "both") {
+    G4String fileName = name.str() + ".json";
+    if (WriteJSON(fileName)) {
+      G4cout << "Run summary written to " << fileName << G4endl;
+    }
+  }
+  if (format == "csv" || format == "both") {
+    G4String fileName = name.str() + ".csv";
+    if (WriteCSV(fileName)) {
+      G4cout << "Run summary written to " << fileName << G4endl;
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool RunSummary::WriteJSON(const G4String& fileName) const
+{
+  std::ofstream out(fileName);
+  if (out) {
+    out << "{";
+    G4String section;
+    for (size_t i = 0; i < fEntries.size(); ++i) {
+      const Entry& e = fEntries[i];
+      if (i == 0 || e.section != section) {
+        if (i > 0) out << "\n  },";
+        out << "\n  " << JSONString(e.section) << ": {";
+        section = e.section;
+      }
+      else out << ",";
+      out << "\n    " << JSONString(e.key) << ": ";
+      if (e.quoted) out << JSONString(e.value);
+      else out << e.value;
+    }
+    if (!fEntries.empty()) out << "\n  }";
+    out << "\n}\n";
+    out.close();
+  }
+  if (!out) {
+    G4ExceptionDescription ed;
+    ed << "Cannot write the run summary to " << fileName;
+    G4Exception("RunSummary::WriteJSON", "OpNovice2_023", JustWarning, ed);
+    return false;
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool RunSummary::WriteCSV(const G4String& fileName) const
+{
+  std::ofstream out(fileName);
+  if (out) {
+    for (size_t i = 0; i < fEntries.size(); ++i) {
+      if (i > 0) out << ",";
+      out << fEntries[i].section << "." << fEntries[i].key;
+    }
+    out << "\n";
+    for (size_t i = 0; i < fEntries.size(); ++i) {
+      const Entry& e = fEntries[i];
+      if (i > 0) out << ",";
+      if (e.quoted) out << CSVString(e.value);
+      else if (e.value != "null") out << e.value;
+    }
+    out << "\n";
+    out.close();
+  }
+  if (!out) {
+    G4ExceptionDescription ed;
+    ed << "Cannot write the run summary to " << fileName;
+    G4Exception("RunSummary::WriteCSV", "OpNovice2_023", JustWarning, ed);
+    return false;
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,168 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/src/StageTimer.cc
+/// \brief Implementation of the StageTimer class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "StageTimer.hh"
+
+#include "G4Threading.hh"
+
+#include <atomic>
+#include <iomanip>
+
+namespace {
+  std::atomic<bool> enabled(false);
+
+  G4ThreadLocal uint64_t cycles[StageTimer::kNStages];
+  G4ThreadLocal uint64_t calls[StageTimer::kNStages];
+  G4ThreadLocal StageTimer::Scope* current = nullptr;
+  // reference points to convert cycles into seconds
+  G4ThreadLocal uint64_t startTicks = 0;
+  G4ThreadLocal double   startTime  = 0.;
+
+  inline double Now()
+  {
+    return std::chrono::duration<double>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+
+  const char* stageNames[StageTimer::kNStages] = {
+    "ntuple", "boundary", "histograms", "secondaries", "trackInfo",
+    "eventBegin", "eventEnd"
+  };
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+StageTimer::Scope::Scope(Stage stage)
+  : fStage(stage), fStart(0), fParent(nullptr),
+    fActive(enabled.load(std::memory_order_relaxed))
+{
+  if (!fActive) return;
+  fStart  = Cycles();
+  fParent = current;
+  if (fParent) cycles[fParent->fStage] += fStart - fParent->fStart;
+  current = this;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+StageTimer::Scope::~Scope()
+{
+  if (!fActive) return;
+  const uint64_t now = Cycles();
+  cycles[fStage] += now - fStart;
+  ++calls[fStage];
+  current = fParent;
+  if (fParent) fParent->fStart = now;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StageTimer::SetEnabled(G4bool value)
+{
+  if (value && !IsCompiled()) {
+    G4ExceptionDescription ed;
+    ed << "Stage timers are not compiled in; "
+       << "rebuild with -DOPNOVICE2_STAGE_TIMERS=ON";
+    G4Exception("StageTimer::SetEnabled", "OpNovice2_019", JustWarning, ed);
+  }
+  enabled = value;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool StageTimer::IsEnabled()
+{
+  return enabled;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool StageTimer::IsCompiled()
+{
+#ifdef OPNOVICE2_STAGE_TIMERS
+  return true;
+#else
+  return false;
+#endif
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StageTimer::Reset()
+{
+  for (G4int i = 0; i < kNStages; ++i) cycles[i] = calls[i] = 0;
+  startTicks = Cycles();
+  startTime  = Now();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StageTimer::Report()
+{
+  if (!IsEnabled() || !IsCompiled()) return;
+
+  uint64_t totalCalls = 0;
+  for (G4int i = 0; i < kNStages; ++i) totalCalls += calls[i];
+  if (totalCalls == 0) return;   // e.g. the master thread
+
+  const double runTime = Now() - startTime;
+  if (runTime <= 0.) return;
+  const double secondsPerTick = runTime/double(Cycles() - startTicks);
+
+  std::ios::fmtflags mode = G4cout.flags();
+  G4int prec = G4cout.precision();
+  G4cout << "Stage timers, thread " << G4Threading::G4GetThreadId()
+         << ", run " << std::setprecision(4) << runTime << " s:" << G4endl;
+  double userTime = 0.;
+  for (G4int i = 0; i < kNStages; ++i) {
+    const double t = cycles[i]*secondsPerTick;
+    userTime += t;
+    G4cout << "  " << std::left << std::setw(12) << stageNames[i]
+           << std::right << std::setw(12) << calls[i] << " calls "
+           << std::setw(10) << t << " s "
+           << std::setw(7) << 100.*t/runTime << " %" << G4endl;
+  }
+  G4cout << "  " << std::left << std::setw(24) << "user actions" << std::right
+         << "       " << std::setw(10) << userTime << " s "
+         << std::setw(7) << 100.*userTime/runTime << " %" << G4endl;
+  G4cout.flags(mode);
+  G4cout.precision(prec);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const char* StageTimer::GetStageName(Stage stage)
+{
+  return stageNames[stage];
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,273 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/src/StepCensus.cc
+/// \brief Implementation of the StepCensus class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "StepCensus.hh"
+#include "StageTimer.hh"
+
+#include "G4LogicalVolume.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4Step.hh"
+#include "G4Track.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4VProcess.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+
+namespace {
+  std::atomic<bool> enabled(false);
+  G4String outputFile;
+
+  // cycle count at the previous step of the current track
+  G4ThreadLocal uint64_t lastCycles = 0;
+
+  const G4int kMaxIndex = (1 << 20) - 1;
+
+  inline G4double Now()
+  {
+    return std::chrono::duration<double>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int StepCensus::Dictionary::Find(const void* key, const G4String& name)
+{
+  auto it = index.find(key);
+  if (it != index.end()) return it->second;
+  G4int i = Find(name);
+  index.emplace(key, i);
+  return i;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int StepCensus::Dictionary::Find(const G4String& name)
+{
+  auto it = std::find(names.begin(), names.end(), name);
+  if (it != names.end()) return it - names.begin();
+  names.push_back(name);
+  return names.size() - 1;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+StepCensus::StepCensus()
+  : fStartTime(Now()),
+    fStartCycles(StageTimer::Cycles())
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+StepCensus::~StepCensus()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StepCensus::SetEnabled(G4bool value)
+{
+  enabled = value;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool StepCensus::IsEnabled()
+{
+  return enabled.load(std::memory_order_relaxed);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StepCensus::SetOutputFile(const G4String& fileName)
+{
+  outputFile = fileName;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const G4String& StepCensus::GetOutputFile()
+{
+  return outputFile;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StepCensus::StartTrack()
+{
+  lastCycles = StageTimer::Cycles();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StepCensus::AddStep(const G4Step* step)
+{
+  const uint64_t now = StageTimer::Cycles();
+  const G4Track* track = step->GetTrack();
+
+  const G4ParticleDefinition* particle = track->GetDefinition();
+  const G4VPhysicalVolume* pv = step->GetPreStepPoint()->GetPhysicalVolume();
+  const G4LogicalVolume* lv = pv ? pv->GetLogicalVolume() : nullptr;
+  const G4VProcess* process =
+    step->GetPostStepPoint()->GetProcessDefinedStep();
+
+  const G4int ip = fParticles.Find(particle, particle->GetParticleName());
+  const G4int iv = fVolumes.Find(lv, lv ? lv->GetName() : G4String("none"));
+  const G4int ir = fProcesses.Find(process,
+    process ? process->GetProcessName() : G4String("none"));
+
+  Cell& cell = fCells[Key(ip, iv, ir)];
+  ++cell.steps;
+  if (track->GetCurrentStepNumber() == 1) ++cell.tracks;
+  cell.cycles += now - lastCycles;
+  lastCycles = now;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StepCensus::Merge(const StepCensus& other)
+{
+  // the worker's indices are translated through the names
+  std::vector<G4int> particles, volumes, processes;
+  for (const G4String& name : other.fParticles.names)
+    particles.push_back(fParticles.Find(name));
+  for (const G4String& name : other.fVolumes.names)
+    volumes.push_back(fVolumes.Find(name));
+  for (const G4String& name : other.fProcesses.names)
+    processes.push_back(fProcesses.Find(name));
+
+  for (const auto& entry : other.fCells) {
+    const uint64_t key = entry.first;
+    Cell& cell = fCells[Key(particles[key >> 40],
+                            volumes[(key >> 20) & kMaxIndex],
+                            processes[key & kMaxIndex])];
+    cell.steps  += entry.second.steps;
+    cell.tracks += entry.second.tracks;
+    cell.cycles += entry.second.cycles;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::vector<std::pair<uint64_t, StepCensus::Cell> >
+StepCensus::SortedCells() const
+{
+  std::vector<std::pair<uint64_t, Cell> > cells(fCells.begin(), fCells.end());
+  std::sort(cells.begin(), cells.end(),
+            [](const std::pair<uint64_t, Cell>& a,
+               const std::pair<uint64_t, Cell>& b)
+            { return a.second.cycles > b.second.cycles; });
+  return cells;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double StepCensus::SecondsPerCycle() const
+{
+  // the cycle rate is the same on every thread, so the master's own run
+  // calibrates the merged counts
+  const uint64_t cycles = StageTimer::Cycles() - fStartCycles;
+  return cycles > 0 ? (Now() - fStartTime)/double(cycles) : 0.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StepCensus::Print(G4int maxRows) const
+{
+  if (fCells.empty()) return;
+
+  const auto cells = SortedCells();
+  const G4double scale = SecondsPerCycle();
+  uint64_t totalCycles = 0;
+  G4long totalSteps = 0;
+  for (const auto& entry : cells) {
+    totalCycles += entry.second.cycles;
+    totalSteps  += entry.second.steps;
+  }
+
+  std::ios::fmtflags mode = G4cout.flags();
+  G4int prec = G4cout.precision(3);
+  G4cout << "\n Step census (" << totalSteps << " steps, "
+         << totalCycles*scale << " s in tracking), by time:\n"
+         << std::left << std::setw(16) << " particle" << std::setw(16)
+         << "volume" << std::setw(20) << "process" << std::right
+         << std::setw(12) << "steps" << std::setw(10) << "tracks"
+         << std::setw(10) << "time [s]" << std::setw(8) << "%" << G4endl;
+  G4int rows = 0;
+  for (const auto& entry : cells) {
+    if (rows++ == maxRows) {
+      G4cout << " ... " << cells.size() - maxRows << " more rows" << G4endl;
+      break;
+    }
+    const uint64_t key = entry.first;
+    const Cell& cell = entry.second;
+    G4cout << " " << std::left
+           << std::setw(15) << fParticles.names[key >> 40]
+           << std::setw(16) << fVolumes.names[(key >> 20) & kMaxIndex]
+           << std::setw(20) << fProcesses.names[key & kMaxIndex]
+           << std::right << std::setw(12) << cell.steps
+           << std::setw(10) << cell.tracks
+           << std::setw(10) << cell.cycles*scale
+           << std::setw(8)
+           << (totalCycles ? 100.*cell.cycles/totalCycles : 0.) << G4endl;
+  }
+  G4cout.flags(mode);
+  G4cout.precision(prec);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StepCensus::Write(const G4String& fileName) const
+{
+  std::ofstream out(fileName);
+  if (!out) {
+    G4ExceptionDescription ed;
+    ed << "Cannot write the step census to " << fileName;
+    G4Exception("StepCensus::Write", "OpNovice2_020", JustWarning, ed);
+    return;
+  }
+  const G4double scale = SecondsPerCycle();
+  out << "particle,volume,process,steps,tracks,seconds\n";
+  for (const auto& entry : SortedCells()) {
+    const uint64_t key = entry.first;
+    out << fParticles.names[key >> 40] << ','
+        << fVolumes.names[(key >> 20) & kMaxIndex] << ','
+        << fProcesses.names[key & kMaxIndex] << ','
+        << entry.second.steps << ',' << entry.second.tracks << ','
+        << entry.second.cycles*scale << '\n';
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
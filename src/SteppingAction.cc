@@ -34,6 +34,9 @@
 #include "HistoManager.hh"
 #include "TrackInformation.hh"
 #include "Run.hh"
+#include "DetectorConstruction.hh"
+#include "StageTimer.hh"
+#include "PerfCounters.hh"
 
 #include "G4Cerenkov.hh"
 #include "G4Scintillation.hh"
@@ -47,6 +50,8 @@
 #include "G4SteppingManager.hh"
 #include "G4RunManager.hh"
 #include "G4ProcessManager.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4LogicalVolume.hh"
 
 #include "G4SystemOfUnits.hh"
 
@@ -54,7 +59,9 @@
 SteppingAction::SteppingAction(B5EventAction *evtAct)
   : G4UserSteppingAction(),
     fVerbose(0),
-    fEvtAction(evtAct)
+    fEvtAction(evtAct),
+    fDetector(nullptr),
+    fBoundary(nullptr)
 {}
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -64,29 +71,79 @@ SteppingAction::~SteppingAction()
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 void SteppingAction::UserSteppingAction(const G4Step* step)
 {
+  PerfCounters::Scope perfScope(PerfCounters::kStepping);
   static G4ParticleDefinition* opticalphoton = 
     G4OpticalPhoton::OpticalPhotonDefinition();
   G4AnalysisManager* analysisMan = G4AnalysisManager::Instance();
   Run* run = static_cast<Run*>(
 			       G4RunManager::GetRunManager()->GetNonConstCurrentRun());
 
+  if (!fDetector) {
+    fDetector = static_cast<const DetectorConstruction*>(
+      G4RunManager::GetRunManager()->GetUserDetectorConstruction());
+    G4ProcessManager* opManager =
+      G4OpticalPhoton::OpticalPhoton()->GetProcessManager();
+    G4ProcessVector* postStepDoItVector =
+      opManager->GetPostStepProcessVector(typeDoIt);
+    for (G4int i = 0; i < G4int(postStepDoItVector->entries()); ++i) {
+      fBoundary = dynamic_cast<G4OpBoundaryProcess*>((*postStepDoItVector)[i]);
+      if (fBoundary) break;
+    }
+  }
+
   G4Track* track = step->GetTrack();
   G4StepPoint* endPoint   = step->GetPostStepPoint();
   G4StepPoint* startPoint = step->GetPreStepPoint();
 
+  run->AddStep();
+  if (StepCensus::IsEnabled()) run->GetCensus().AddStep(step);
+  if (track->GetCurrentStepNumber() == 1 &&
+      track->GetDefinition() == opticalphoton) run->AddTrackedPhoton();
+
   G4String particleName = track->GetDynamicParticle()->
     GetParticleDefinition()->GetParticleName();
 
   TrackInformation* trackInfo = 
     (TrackInformation*)(track->GetUserInformation());
 
+  // photon history, updated before a hit is written
+  G4bool isPhoton = track->GetDefinition() == opticalphoton;
+  G4OpBoundaryProcessStatus boundaryStatus = Undefined;
+  if (isPhoton) {
+    if (fDetector->IsTankVolume(
+          startPoint->GetPhysicalVolume()->GetLogicalVolume())) {
+      trackInfo->AddTankPath(step->GetStepLength());
+    }
+    if (fBoundary && endPoint->GetStepStatus() == fGeomBoundary) {
+      boundaryStatus = fBoundary->GetStatus();
+      trackInfo->AddBoundary(boundaryStatus);
+    }
+  }
+
   G4Material *mat = endPoint->GetMaterial();
   if(mat){
+    //readout planes are tagged by the detector construction
+    G4bool isReadout = fDetector->IsReadoutVolume(
+      endPoint->GetPhysicalVolume()->GetLogicalVolume());
+    G4int detID(0); //default is quartz for primary
+    if (isReadout) {
+      //plane (1 top, 2 bottom) + 10*bar
+      detID = fDetector->GetDetectorID(endPoint->GetTouchable());
+    }
+    // a photon may reach the readout in several steps, the tally takes
+    // its first arrival
+    if (isReadout && isPhoton && !trackInfo->IsDetected()) {
+      trackInfo->SetDetected();
+      run->AddDetectedPhoton();
+      run->GetDetectorTally().AddHit(detID, track->GetGlobalTime(),
+                                     endPoint->GetTotalEnergy());
+    }
     if( (track->GetTrackID()==1 && track->GetParentID()==0) || //primary
-	(particleName == "opticalphoton" && mat->GetName().compare("G4_Pb")==0)){ //optical photons that hit the "detectors"
+	(particleName == "opticalphoton" && isReadout)){ //optical photons that hit the "detectors"
       //fill ntuple
       G4AnalysisManager *ana = G4AnalysisManager::Instance();
       if(ana){
+	OPNOVICE2_STAGE_TIMER(kNtuple);
 	ana->FillNtupleDColumn( 0,endPoint->GetPosition().getX());
 	ana->FillNtupleDColumn( 1,endPoint->GetPosition().getY());
 	ana->FillNtupleDColumn( 2,endPoint->GetPosition().getZ());
@@ -100,17 +157,23 @@ void SteppingAction::UserSteppingAction(const G4Step* step)
 	ana->FillNtupleDColumn(10,endPoint->GetKineticEnergy());
 	ana->FillNtupleIColumn(11,fEvtAction->GetEventID());
 	ana->FillNtupleDColumn(12,track->GetGlobalTime());
-	G4int detID(0); //default is quartz for primary
-	if(mat->GetName().compare("G4_Pb")==0){
-	  if(endPoint->GetPosition().getY()>0)
-	    detID=1;//top
-	  else if(endPoint->GetPosition().getY()<0)
-	    detID=2;//bottom
-	  else
-	    detID=-1;//error
-	}
 	ana->FillNtupleIColumn(13,detID);
 	ana->AddNtupleRow();
+	run->AddHit(fEvtAction->GetEventID(), track->GetTrackID(),
+	            track->GetDefinition()->GetPDGEncoding(), detID,
+	            endPoint->GetPosition(), track->GetGlobalTime());
+	if (MemoryMonitor::IsEnabled()) run->GetMemoryMonitor().AddNtupleRow();
+	if (isReadout && isPhoton && TrackInformation::GetWriteHistory()) {
+	  ana->FillNtupleIColumn(1, 0, fEvtAction->GetEventID());
+	  ana->FillNtupleIColumn(1, 1, track->GetTrackID());
+	  ana->FillNtupleIColumn(1, 2, detID);
+	  ana->FillNtupleIColumn(1, 3, trackInfo->GetCreator());
+	  ana->FillNtupleIColumn(1, 4, trackInfo->GetBounces());
+	  ana->FillNtupleIColumn(1, 5, trackInfo->GetTotalInternalReflections());
+	  ana->FillNtupleDColumn(1, 6, trackInfo->GetTankPath());
+	  ana->FillNtupleIColumn(1, 7, trackInfo->GetFirstBoundaryStatus());
+	  ana->AddNtupleRow(1);
+	}
       }
     }
   }
@@ -128,6 +191,7 @@ void SteppingAction::UserSteppingAction(const G4Step* step)
 
     // optical process has endpt on bdry, 
     if (endPoint->GetStepStatus() == fGeomBoundary) {
+      OPNOVICE2_STAGE_TIMER(kBoundary);
 
       const G4DynamicParticle* theParticle = track->GetDynamicParticle();
 
@@ -136,167 +200,156 @@ void SteppingAction::UserSteppingAction(const G4Step* step)
       G4ThreeVector m0 = startPoint->GetMomentumDirection();
       G4ThreeVector m1 = endPoint->GetMomentumDirection();
 
-      G4OpBoundaryProcessStatus theStatus = Undefined;
-
-      G4ProcessManager* OpManager = 
-        G4OpticalPhoton::OpticalPhoton()->GetProcessManager();
-      G4int MAXofPostStepLoops = 
-        OpManager->GetPostStepProcessVector()->entries();
-      G4ProcessVector* postStepDoItVector = 
-        OpManager->GetPostStepProcessVector(typeDoIt);
+      G4OpBoundaryProcessStatus theStatus = boundaryStatus;
 
       if (trackInfo->GetIsFirstTankX()) {
         G4ThreeVector momdir = endPoint->GetMomentumDirection();
         G4double px1 = momdir.x();
         G4double py1 = momdir.y();
         G4double pz1 = momdir.z();
-        if (px1 < 0.) {
-          analysisMan->FillH1(4, px1);
-          analysisMan->FillH1(5, py1);
-          analysisMan->FillH1(6, pz1);
-        } else if (px1 >= 0.) {
-          analysisMan->FillH1(7, px1);
-          analysisMan->FillH1(8, py1);
-          analysisMan->FillH1(9, pz1);
+        {
+          OPNOVICE2_STAGE_TIMER(kHistograms);
+          if (px1 < 0.) {
+            analysisMan->FillH1(4, px1);
+            analysisMan->FillH1(5, py1);
+            analysisMan->FillH1(6, pz1);
+          } else if (px1 >= 0.) {
+            analysisMan->FillH1(7, px1);
+            analysisMan->FillH1(8, py1);
+            analysisMan->FillH1(9, pz1);
+          }
         }
 
         trackInfo->SetIsFirstTankX(false);
+        trackInfo->SetFirstBoundaryStatus(theStatus);
         run->AddTotalSurface(); 
 
-        for (G4int i=0; i<MAXofPostStepLoops; ++i) {
-          G4VProcess* currentProcess = (*postStepDoItVector)[i];
-
-          G4OpBoundaryProcess* opProc = 
-            dynamic_cast<G4OpBoundaryProcess*>(currentProcess);
-          if (opProc) {
-            theStatus = opProc->GetStatus();
-            analysisMan->FillH1(3, theStatus);
-            if (theStatus == Transmission) {
-              run->AddTransmission();
-            }
-            else if (theStatus == FresnelRefraction) {
-              run->AddFresnelRefraction(); 
-              analysisMan->FillH1(10, px1);
-              analysisMan->FillH1(11, py1);
-              analysisMan->FillH1(12, pz1);
-            }
-            else if (theStatus == FresnelReflection) { 
-              run->AddFresnelReflection(); 
-            }
-            else if (theStatus == TotalInternalReflection) { 
-              run->AddTotalInternalReflection();
-            }
-            else if (theStatus == LambertianReflection) {
-              run->AddLambertianReflection();
-            }
-            else if (theStatus == LobeReflection) {
-              run->AddLobeReflection();
-            }
-            else if (theStatus == SpikeReflection) {
-              run->AddSpikeReflection();
-            }
-            else if (theStatus == BackScattering) {
-              run->AddBackScattering();
-            }
-            else if (theStatus == Absorption) {
-              run->AddAbsorption();
-            }
-            else if (theStatus == Detection) {
-              run->AddDetection();
-            }
-            else if (theStatus == NotAtBoundary) {
-              run->AddNotAtBoundary();
-            }
-            else if (theStatus == SameMaterial) {
-              run->AddSameMaterial();
-            }
-            else if (theStatus == StepTooSmall) {
-              run->AddStepTooSmall();
-            }
-            else if (theStatus == NoRINDEX) {
-              run->AddNoRINDEX();
-            }
-            else if (theStatus == PolishedLumirrorAirReflection) {
-              run->AddPolishedLumirrorAirReflection();
-            }
-            else if (theStatus == PolishedLumirrorGlueReflection) {
-              run->AddPolishedLumirrorGlueReflection();
-            }
-            else if (theStatus == PolishedAirReflection) {
-              run->AddPolishedAirReflection();
-            }
-            else if (theStatus == PolishedTeflonAirReflection) {
-              run->AddPolishedTeflonAirReflection();
-            }
-            else if (theStatus == PolishedTiOAirReflection) {
-              run->AddPolishedTiOAirReflection();
-            }
-            else if (theStatus == PolishedTyvekAirReflection) {
-              run->AddPolishedTyvekAirReflection();
-            }
-            else if (theStatus == PolishedVM2000AirReflection) {
-              run->AddPolishedVM2000AirReflection();
-            }
-            else if (theStatus == PolishedVM2000GlueReflection) {
-              run->AddPolishedVM2000AirReflection();
-            }
-            else if (theStatus == EtchedLumirrorAirReflection) {
-              run->AddEtchedLumirrorAirReflection();
-            }
-            else if (theStatus == EtchedLumirrorGlueReflection) {
-              run->AddEtchedLumirrorGlueReflection();
-            }
-            else if (theStatus == EtchedAirReflection) {
-              run->AddEtchedAirReflection();
-            }
-            else if (theStatus == EtchedTeflonAirReflection) {
-              run->AddEtchedTeflonAirReflection();
-            }
-            else if (theStatus == EtchedTiOAirReflection) {
-              run->AddEtchedTiOAirReflection();
-            }
-            else if (theStatus == EtchedTyvekAirReflection) {
-              run->AddEtchedTyvekAirReflection();
-            }
-            else if (theStatus == EtchedVM2000AirReflection) {
-              run->AddEtchedVM2000AirReflection();
-            }
-            else if (theStatus == EtchedVM2000GlueReflection) {
-              run->AddEtchedVM2000AirReflection();
-            }
-            else if (theStatus == GroundLumirrorAirReflection) {
-              run->AddGroundLumirrorAirReflection();
-            }
-            else if (theStatus == GroundLumirrorGlueReflection) {
-              run->AddGroundLumirrorGlueReflection();
-            }
-            else if (theStatus == GroundAirReflection) {
-              run->AddGroundAirReflection();
-            }
-            else if (theStatus == GroundTeflonAirReflection) {
-              run->AddGroundTeflonAirReflection();
-            }
-            else if (theStatus == GroundTiOAirReflection) {
-              run->AddGroundTiOAirReflection();
-            }
-            else if (theStatus == GroundTyvekAirReflection) {
-              run->AddGroundTyvekAirReflection();
-            }
-            else if (theStatus == GroundVM2000AirReflection) {
-              run->AddGroundVM2000AirReflection();
-            }
-            else if (theStatus == GroundVM2000GlueReflection) {
-              run->AddGroundVM2000AirReflection();
-            }
-            else if (theStatus == Dichroic) {
-              run->AddDichroic();
-            }
-            
-            else {
-              G4cout << "theStatus: " << theStatus 
-                     << " was none of the above." << G4endl;
-            }
-
+        if (fBoundary) {
+          analysisMan->FillH1(3, theStatus);
+          if (theStatus == Transmission) {
+            run->AddTransmission();
+          }
+          else if (theStatus == FresnelRefraction) {
+            run->AddFresnelRefraction(); 
+            analysisMan->FillH1(10, px1);
+            analysisMan->FillH1(11, py1);
+            analysisMan->FillH1(12, pz1);
+          }
+          else if (theStatus == FresnelReflection) { 
+            run->AddFresnelReflection(); 
+          }
+          else if (theStatus == TotalInternalReflection) { 
+            run->AddTotalInternalReflection();
+          }
+          else if (theStatus == LambertianReflection) {
+            run->AddLambertianReflection();
+          }
+          else if (theStatus == LobeReflection) {
+            run->AddLobeReflection();
+          }
+          else if (theStatus == SpikeReflection) {
+            run->AddSpikeReflection();
+          }
+          else if (theStatus == BackScattering) {
+            run->AddBackScattering();
+          }
+          else if (theStatus == Absorption) {
+            run->AddAbsorption();
+          }
+          else if (theStatus == Detection) {
+            run->AddDetection();
+          }
+          else if (theStatus == NotAtBoundary) {
+            run->AddNotAtBoundary();
+          }
+          else if (theStatus == SameMaterial) {
+            run->AddSameMaterial();
+          }
+          else if (theStatus == StepTooSmall) {
+            run->AddStepTooSmall();
+          }
+          else if (theStatus == NoRINDEX) {
+            run->AddNoRINDEX();
+          }
+          else if (theStatus == PolishedLumirrorAirReflection) {
+            run->AddPolishedLumirrorAirReflection();
+          }
+          else if (theStatus == PolishedLumirrorGlueReflection) {
+            run->AddPolishedLumirrorGlueReflection();
+          }
+          else if (theStatus == PolishedAirReflection) {
+            run->AddPolishedAirReflection();
+          }
+          else if (theStatus == PolishedTeflonAirReflection) {
+            run->AddPolishedTeflonAirReflection();
+          }
+          else if (theStatus == PolishedTiOAirReflection) {
+            run->AddPolishedTiOAirReflection();
+          }
+          else if (theStatus == PolishedTyvekAirReflection) {
+            run->AddPolishedTyvekAirReflection();
+          }
+          else if (theStatus == PolishedVM2000AirReflection) {
+            run->AddPolishedVM2000AirReflection();
+          }
+          else if (theStatus == PolishedVM2000GlueReflection) {
+            run->AddPolishedVM2000AirReflection();
+          }
+          else if (theStatus == EtchedLumirrorAirReflection) {
+            run->AddEtchedLumirrorAirReflection();
+          }
+          else if (theStatus == EtchedLumirrorGlueReflection) {
+            run->AddEtchedLumirrorGlueReflection();
+          }
+          else if (theStatus == EtchedAirReflection) {
+            run->AddEtchedAirReflection();
+          }
+          else if (theStatus == EtchedTeflonAirReflection) {
+            run->AddEtchedTeflonAirReflection();
+          }
+          else if (theStatus == EtchedTiOAirReflection) {
+            run->AddEtchedTiOAirReflection();
+          }
+          else if (theStatus == EtchedTyvekAirReflection) {
+            run->AddEtchedTyvekAirReflection();
+          }
+          else if (theStatus == EtchedVM2000AirReflection) {
+            run->AddEtchedVM2000AirReflection();
+          }
+          else if (theStatus == EtchedVM2000GlueReflection) {
+            run->AddEtchedVM2000AirReflection();
+          }
+          else if (theStatus == GroundLumirrorAirReflection) {
+            run->AddGroundLumirrorAirReflection();
+          }
+          else if (theStatus == GroundLumirrorGlueReflection) {
+            run->AddGroundLumirrorGlueReflection();
+          }
+          else if (theStatus == GroundAirReflection) {
+            run->AddGroundAirReflection();
+          }
+          else if (theStatus == GroundTeflonAirReflection) {
+            run->AddGroundTeflonAirReflection();
+          }
+          else if (theStatus == GroundTiOAirReflection) {
+            run->AddGroundTiOAirReflection();
+          }
+          else if (theStatus == GroundTyvekAirReflection) {
+            run->AddGroundTyvekAirReflection();
+          }
+          else if (theStatus == GroundVM2000AirReflection) {
+            run->AddGroundVM2000AirReflection();
+          }
+          else if (theStatus == GroundVM2000GlueReflection) {
+            run->AddGroundVM2000AirReflection();
+          }
+          else if (theStatus == Dichroic) {
+            run->AddDichroic();
+          }
+          
+          else {
+            G4cout << "theStatus: " << theStatus 
+                   << " was none of the above." << G4endl;
           }
         }
       }
@@ -304,6 +357,7 @@ void SteppingAction::UserSteppingAction(const G4Step* step)
   }
 
   else { // particle != opticalphoton
+    OPNOVICE2_STAGE_TIMER(kSecondaries);
 
     // print how many Cerenkov and scint photons produced this step
     // this demonstrates use of GetNumPhotons()
@@ -32,29 +32,41 @@
 #include "TrackInformation.hh"
 #include "G4ios.hh"
 #include "G4SystemOfUnits.hh"    
+#include "G4UnitsTable.hh"
+#include "G4VProcess.hh"
+#include "G4OpProcessSubType.hh"
 
 G4ThreadLocal G4Allocator<TrackInformation> *
                                    aTrackInformationAllocator = 0;
 
+namespace {
+  G4bool writeHistory = false;
+}
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 TrackInformation::TrackInformation()
-  : G4VUserTrackInformation()
-{
-  fFirstTankX = true;
-}
+  : G4VUserTrackInformation(),
+    fTankPath(0.f),
+    fBounces(0),
+    fTIRs(0),
+    fCreator(kPrimary),
+    fFirstBoundary(Undefined),
+    fFirstTankX(true),
+    fDetected(false)
+{}
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
-TrackInformation::TrackInformation(const G4Track*)
+TrackInformation::TrackInformation(const G4Track* aTrack)
   : G4VUserTrackInformation()
 {
-  fFirstTankX = true;
+  SetSourceTrackInformation(aTrack);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 TrackInformation ::TrackInformation(const TrackInformation* aTrackInfo)
   : G4VUserTrackInformation()
 {
-  fFirstTankX = aTrackInfo->fFirstTankX;
+  *this = *aTrackInfo;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -65,22 +77,52 @@ TrackInformation::~TrackInformation()
 TrackInformation& TrackInformation::operator=
   (const TrackInformation& aTrackInfo)
 {
+  fTankPath = aTrackInfo.fTankPath;
+  fBounces = aTrackInfo.fBounces;
+  fTIRs = aTrackInfo.fTIRs;
+  fCreator = aTrackInfo.fCreator;
+  fFirstBoundary = aTrackInfo.fFirstBoundary;
   fFirstTankX = aTrackInfo.fFirstTankX;
+  fDetected = aTrackInfo.fDetected;
 
   return *this;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
-void TrackInformation::SetSourceTrackInformation(const G4Track*)
+void TrackInformation::SetSourceTrackInformation(const G4Track* aTrack)
 {
+  fTankPath = 0.f;
+  fBounces = 0;
+  fTIRs = 0;
+  fFirstBoundary = Undefined;
   fFirstTankX = true;
+  fDetected = false;
+
+  // the sub-type avoids comparing process names for every track
+  const G4VProcess* creator = aTrack ? aTrack->GetCreatorProcess() : nullptr;
+  if (!creator) fCreator = kPrimary;
+  else if (creator->GetProcessSubType() == fCerenkov) fCreator = kCerenkov;
+  else if (creator->GetProcessSubType() == fScintillation) {
+    fCreator = kScintillation;
+  }
+  else if (creator->GetProcessSubType() == fOpWLS) fCreator = kWLS;
+  else fCreator = kOther;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 void TrackInformation::Print() const
 {
   G4cout 
-    << "first time track incident on X: " << fFirstTankX << G4endl;
+    << "first time track incident on X: " << fFirstTankX << G4endl
+    << "creator: " << G4int(fCreator) << ", bounces: " << fBounces
+    << ", total internal reflections: " << fTIRs
+    << ", path in tank: " << G4BestUnit(G4double(fTankPath), "Length")
+    << ", first boundary status: " << G4int(fFirstBoundary) << G4endl;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void TrackInformation::SetWriteHistory(G4bool value) {writeHistory = value;}
+
+G4bool TrackInformation::GetWriteHistory() {return writeHistory;}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -30,8 +30,12 @@
 
 #include "TrackingAction.hh"
 #include "TrackInformation.hh"
+#include "StageTimer.hh"
+#include "PerfCounters.hh"
+#include "StepCensus.hh"
+#include "Run.hh"
 
-#include "G4TrackingManager.hh"
+#include "G4RunManager.hh"
 #include "G4Track.hh"
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -41,36 +45,25 @@ TrackingAction::TrackingAction()
 
 void TrackingAction::PreUserTrackingAction(const G4Track* aTrack)
 {
-  // Create trajectory only for track in tracking region
+  PerfCounters::Scope perfScope(PerfCounters::kTracking);
+  OPNOVICE2_STAGE_TIMER(kTrackInfo);
+  if (StepCensus::IsEnabled()) StepCensus::StartTrack();
+  if (MemoryMonitor::IsEnabled()) {
+    static_cast<Run*>(G4RunManager::GetRunManager()->GetNonConstCurrentRun())
+      ->GetMemoryMonitor().SampleStack();
+  }
+  // created here rather than for every secondary when it is stacked,
+  // so only the tracks being tracked hold one
   TrackInformation* trackInfo = 
     (TrackInformation*)(aTrack->GetUserInformation());
 
   if (!trackInfo) {
     trackInfo = new TrackInformation(aTrack); 
-    trackInfo->SetIsFirstTankX(true);
     aTrack->SetUserInformation(trackInfo);
   }
-
-  trackInfo->SetIsFirstTankX(true);
-
+  else {
+    trackInfo->SetSourceTrackInformation(aTrack);
+  }
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
-void TrackingAction::PostUserTrackingAction(const G4Track* aTrack)
-{
-  G4TrackVector* secondaries = fpTrackingManager->GimmeSecondaries();
-  if (secondaries)
-  {
-    TrackInformation* info = 
-      (TrackInformation*)(aTrack->GetUserInformation());
-    size_t nSeco = secondaries->size();
-    if (nSeco > 0)
-    {
-      for(size_t i=0; i < nSeco; i++)
-      { 
-        TrackInformation* infoNew = new TrackInformation(info);
-        (*secondaries)[i]->SetUserInformation(infoNew);
-      }
-    }
-  }
-}
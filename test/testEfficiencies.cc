@@ -0,0 +1,89 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/test/testEfficiencies.cc
+/// \brief Checks the Wilson intervals of Efficiencies at the edges
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "Efficiencies.hh"
+#include "TestCheck.hh"
+
+#include <cmath>
+
+namespace {
+  G4bool Near(G4double a, G4double b) {return std::abs(a - b) < 1.e-9;}
+
+  // one event with the given counts for detection, fresnelRefraction,
+  // fresnelReflection and absorptionPrior
+  void Fill(Efficiencies& eff, G4long p0, G4long n0, G4long p1, G4long n1,
+            G4long p2, G4long n2, G4long p3, G4long n3)
+  {
+    const G4long pass[Efficiencies::kNQuantities]  = {p0, p1, p2, p3};
+    const G4long total[Efficiencies::kNQuantities] = {n0, n1, n2, n3};
+    eff.EndEvent(pass, total);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+int main()
+{
+  using TestCheck::Check;
+
+  const G4double z = 1.96, z2 = z*z;
+  G4double low, high;
+
+  // p = 0, p = 1, a single trial and no trial
+  Efficiencies eff;
+  Fill(eff, 0, 10, 10, 10, 1, 1, 0, 0);
+
+  eff.GetWilson(Efficiencies::kDetection, z, low, high);
+  Check(low == 0. && Near(high, z2/(10. + z2)), "Wilson at p = 0");
+  eff.GetWilson(Efficiencies::kFresnelRefraction, z, low, high);
+  Check(Near(low, 10./(10. + z2)) && high == 1., "Wilson at p = 1");
+  eff.GetWilson(Efficiencies::kFresnelReflection, z, low, high);
+  Check(Near(low, 1./(1. + z2)) && Near(high, 1.), "Wilson with n = 1");
+  eff.GetWilson(Efficiencies::kAbsorptionPrior, z, low, high);
+  Check(low == 0. && high == 1., "Wilson with n = 0");
+
+  for (G4int i = 0; i < Efficiencies::kNQuantities; ++i) {
+    Efficiencies::Quantity q = Efficiencies::Quantity(i);
+    Check(std::isfinite(eff.GetError(q)), "finite error at the edges");
+    Check(eff.GetBatchError(q) < 0., "no batch error before ten batches");
+  }
+
+  // symmetric around one half
+  Efficiencies half;
+  Fill(half, 50, 100, 0, 0, 0, 0, 0, 0);
+  half.GetWilson(Efficiencies::kDetection, z, low, high);
+  Check(Near(low + high, 1.) && low > 0.4 && high < 0.6, "Wilson at p = 0.5");
+
+  return TestCheck::ExitStatus();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
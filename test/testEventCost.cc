@@ -0,0 +1,132 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/test/testEventCost.cc
+/// \brief Checks the event time percentiles of EventCost
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "EventCost.hh"
+#include "EventSeeder.hh"
+#include "RunSummary.hh"
+#include "TestCheck.hh"
+
+#include "G4Event.hh"
+
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+namespace {
+  // an event taking at least the given wall time
+  void Spin(EventCost& cost, G4int id, G4double seconds)
+  {
+    G4Event event(id);
+    cost.BeginEvent(0, 0);
+    auto start = std::chrono::steady_clock::now();
+    while (std::chrono::duration<G4double>(
+             std::chrono::steady_clock::now() - start).count() < seconds) {}
+    cost.EndEvent(&event, 1, 1);
+  }
+
+  // value of "key": in the JSON summary
+  G4double Value(const std::string& json, const std::string& key)
+  {
+    std::string::size_type pos = json.find("\"" + key + "\": ");
+    if (pos == std::string::npos) return -1.;
+    std::istringstream is(json.substr(pos + key.size() + 4));
+    G4double value = -1.;
+    is >> value;
+    return value;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+int main()
+{
+  using TestCheck::Check;
+
+  // a shard starting at global event 1000, seeded per event
+  EventSeeder::SetSeed(4242);
+  EventSeeder::SetOffset(1000);
+
+  // 50 fast events and 60 of at least 3 ms: the median is a slow one
+  EventCost::SetNumberOfWorst(3);
+  EventCost cost;
+  G4int id = 0;
+  for (G4int i = 0; i < 50; ++i) Spin(cost, id++, 1.e-5);
+  for (G4int i = 0; i < 60; ++i) Spin(cost, id++, 3.e-3);
+
+  const G4double p50 = cost.Percentile(50.);
+  Check(p50 >= 2.e-3, "median in the slow events, Percentile takes percent");
+  Check(p50 <= cost.Percentile(90.), "p50 <= p90");
+  Check(cost.Percentile(90.) <= cost.Percentile(99.), "p90 <= p99");
+
+  // the summary has the percentiles that Print shows
+  RunSummary::SetFormat("json");
+  RunSummary summary;
+  cost.FillSummary(summary);
+  summary.Write("testEventCost.root", 0);
+  std::ifstream in("testEventCost_run0.json");
+  std::stringstream json;
+  json << in.rdbuf();
+  const G4double stored = Value(json.str(), "p50_s");
+  Check(std::abs(stored - p50) <= 1.e-9*p50, "summary p50_s is the median");
+  Check(Value(json.str(), "p999_s") >= Value(json.str(), "p99_s"),
+        "summary p999_s >= p99_s");
+
+  // the most expensive events by global number, with the seeds to replay
+  const G4double worst = Value(json.str(), "worst0_event");
+  Check(worst >= 1000 && worst < 1110, "worst event by global number");
+  Check(Value(json.str(), "worst0_s") >= 3.e-3, "worst event time");
+  Check(Value(json.str(), "worst2_s") <= Value(json.str(), "worst0_s"),
+        "worst events sorted");
+  Check(json.str().find("worst3_") == std::string::npos, "three worst events");
+  G4Event event(G4int(worst) - 1000);
+  long seeds[2];
+  EventSeeder::GetEventSeeds(&event, seeds);
+  Check(Value(json.str(), "worst0_seed0") == seeds[0] &&
+        Value(json.str(), "worst0_seed1") == seeds[1], "worst event seeds");
+
+  // no events, no percentiles
+  EventCost empty;
+  RunSummary emptySummary;
+  empty.FillSummary(emptySummary);
+  emptySummary.Write("testEventCostEmpty.root", 0);
+  std::ifstream emptyIn("testEventCostEmpty_run0.json");
+  std::stringstream emptyJson;
+  emptyJson << emptyIn.rdbuf();
+  Check(emptyJson.str().find("\"p50_s\": null") != std::string::npos,
+        "p50_s is null without events");
+
+  return TestCheck::ExitStatus();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
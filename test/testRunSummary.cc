@@ -0,0 +1,108 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/test/testRunSummary.cc
+/// \brief Checks the JSON and CSV files written by RunSummary
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "RunSummary.hh"
+#include "TestCheck.hh"
+
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <string>
+
+namespace {
+  std::string Read(const std::string& fileName)
+  {
+    std::ifstream in(fileName);
+    std::stringstream text;
+    text << in.rdbuf();
+    return text.str();
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+int main()
+{
+  using TestCheck::Check;
+
+  RunSummary summary;
+  summary.Add("configuration", "material", G4String("Water \"pure\""));
+  summary.Add("configuration", "threads", 4);
+  summary.Add("counters", "steps", G4long(12345678901));
+  summary.Add("counters", "energy_eV", 2.5);
+  summary.Add("counters", "ratio", std::numeric_limits<G4double>::quiet_NaN());
+  summary.Add("counters", "reached", true);
+  summary.AddNull("counters", "ipc");
+
+  RunSummary::SetFormat("both");
+  summary.Write("testRunSummary.root", 7);
+
+  // sections grouped in order, strings escaped, non-finite values null
+  const std::string json =
+    "{\n"
+    "  \"summary\": {\n"
+    "    \"format\": \"opnovice2-run-summary\",\n"
+    "    \"version\": 1\n"
+    "  },\n"
+    "  \"configuration\": {\n"
+    "    \"material\": \"Water \\\"pure\\\"\",\n"
+    "    \"threads\": 4\n"
+    "  },\n"
+    "  \"counters\": {\n"
+    "    \"steps\": 12345678901,\n"
+    "    \"energy_eV\": 2.5,\n"
+    "    \"ratio\": null,\n"
+    "    \"reached\": true,\n"
+    "    \"ipc\": null\n"
+    "  }\n"
+    "}\n";
+  Check(Read("testRunSummary_run7.json") == json, "JSON summary");
+
+  // one header line of section.key, one line of values
+  const std::string csv =
+    "summary.format,summary.version,configuration.material,"
+    "configuration.threads,counters.steps,counters.energy_eV,"
+    "counters.ratio,counters.reached,counters.ipc\n"
+    "\"opnovice2-run-summary\",1,\"Water \"\"pure\"\"\",4,12345678901,"
+    "2.5,,true,\n";
+  Check(Read("testRunSummary_run7.csv") == csv, "CSV summary");
+
+  // none writes nothing
+  RunSummary::SetFormat("none");
+  summary.Write("testRunSummaryNone", 0);
+  Check(!std::ifstream("testRunSummaryNone_run0.json"), "format none");
+
+  return TestCheck::ExitStatus();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,101 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file optical/OpNovice2/test/testTrackInformation.cc
+/// \brief Checks the photon history kept in TrackInformation
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "TrackInformation.hh"
+#include "TestCheck.hh"
+
+#include "G4SystemOfUnits.hh"
+
+#include <cmath>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+int main()
+{
+  using TestCheck::Check;
+
+  TrackInformation* info = new TrackInformation();
+  Check(info->GetCreator() == TrackInformation::kPrimary &&
+        info->GetBounces() == 0 && info->GetTotalInternalReflections() == 0 &&
+        info->GetTankPath() == 0. &&
+        info->GetFirstBoundaryStatus() == Undefined &&
+        info->GetIsFirstTankX() && !info->IsDetected(), "empty history");
+
+  // reflections of every kind are bounces, refractions are not
+  info->AddBoundary(FresnelReflection);
+  info->AddBoundary(TotalInternalReflection);
+  info->AddBoundary(LambertianReflection);
+  info->AddBoundary(PolishedLumirrorAirReflection);
+  info->AddBoundary(GroundVM2000GlueReflection);
+  info->AddBoundary(FresnelRefraction);
+  info->AddBoundary(Absorption);
+  info->AddBoundary(Detection);
+  Check(info->GetBounces() == 5, "bounces");
+  Check(info->GetTotalInternalReflections() == 1, "total internal reflections");
+
+  // the path is kept in single precision
+  info->AddTankPath(1.5*cm);
+  info->AddTankPath(2.5*cm);
+  Check(std::abs(info->GetTankPath() - 4.*cm) < 1.e-6*cm, "tank path");
+
+  info->SetFirstBoundaryStatus(FresnelRefraction);
+  Check(info->GetFirstBoundaryStatus() == FresnelRefraction,
+        "first boundary status");
+  info->SetIsFirstTankX(false);
+  info->SetDetected();
+
+  // the counters saturate instead of wrapping around
+  for (G4int i = 0; i < 70000; ++i) info->AddBoundary(TotalInternalReflection);
+  Check(info->GetBounces() == 65535 &&
+        info->GetTotalInternalReflections() == 65535, "saturation");
+
+  // a copy keeps the whole history
+  TrackInformation* copy = new TrackInformation(info);
+  Check(copy->GetBounces() == info->GetBounces() &&
+        copy->GetTankPath() == info->GetTankPath() &&
+        copy->GetFirstBoundaryStatus() == FresnelRefraction &&
+        !copy->GetIsFirstTankX() && copy->IsDetected(), "copy");
+
+  // a track without creator process is a primary with a fresh history
+  copy->SetSourceTrackInformation(nullptr);
+  Check(copy->GetCreator() == TrackInformation::kPrimary &&
+        copy->GetBounces() == 0 && copy->GetTotalInternalReflections() == 0 &&
+        copy->GetTankPath() == 0. &&
+        copy->GetFirstBoundaryStatus() == Undefined &&
+        copy->GetIsFirstTankX() && !copy->IsDetected(), "reset");
+
+  delete copy;
+  delete info;
+  return TestCheck::ExitStatus();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......